@@ -0,0 +1,306 @@
+// Header
+#include "alloc_tracker.hpp"
+
+// stlib
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+MemoryTracker memory_tracker;
+
+namespace
+{
+	thread_local MemoryTag current_tag = MemoryTag::OTHER;
+
+	// Zero before any constructor runs, operator new is called from static initializers
+	std::atomic<bool> tracking(false);
+	std::atomic<int64_t> live_bytes[memory_tag_count];
+	std::atomic<uint64_t> frame_allocations[memory_tag_count];
+	std::atomic<uint64_t> frame_bytes[memory_tag_count];
+
+	const char* TAG_NAMES[memory_tag_count] = { "other", "ecs", "dialogue", "images", "imgui", "audio", "saves", "battle" };
+
+	// Starting points for the kiosk builds, to be tightened with the report of a long session
+	const size_t MB = 1024 * 1024;
+	const size_t DEFAULT_BUDGETS[memory_tag_count] = {
+		0,        // other
+		16 * MB,  // ecs
+		2 * MB,   // dialogue
+		32 * MB,  // images, only while decoding before the upload
+		16 * MB,  // imgui, mostly the font atlas
+		96 * MB,  // audio, the decoded sounds and music
+		4 * MB,   // saves
+		4 * MB,   // battle
+	};
+
+#ifdef LOTL_TRACK_ALLOCATIONS
+	thread_local uint64_t allocations = 0;
+
+	// In front of every allocation, so freeing it knows how much goes back to which tag
+	struct BlockHeader
+	{
+		size_t size;
+		uint8_t tag;
+		// allocated while tracking, only then it was added to the tag
+		bool tracked;
+	};
+	// keeps the memory after the header aligned like malloc's
+	const size_t HEADER_SIZE = alignof(std::max_align_t);
+	static_assert(sizeof(BlockHeader) <= HEADER_SIZE, "the block header must fit in front of the alignment");
+
+	void* allocate(size_t size, MemoryTag tag)
+	{
+		if (size > SIZE_MAX - HEADER_SIZE)
+			return nullptr;
+		BlockHeader* header = static_cast<BlockHeader*>(std::malloc(HEADER_SIZE + size));
+		if (header == nullptr)
+			return nullptr;
+		header->size = size;
+		header->tag = (uint8_t)tag;
+		header->tracked = tracking.load(std::memory_order_relaxed);
+		if (header->tracked) {
+			int t = (int)tag;
+			live_bytes[t].fetch_add((int64_t)size, std::memory_order_relaxed);
+			frame_allocations[t].fetch_add(1, std::memory_order_relaxed);
+			frame_bytes[t].fetch_add(size, std::memory_order_relaxed);
+		}
+		return reinterpret_cast<char*>(header) + HEADER_SIZE;
+	}
+
+	BlockHeader* header_of(void* memory)
+	{
+		return reinterpret_cast<BlockHeader*>(static_cast<char*>(memory) - HEADER_SIZE);
+	}
+
+	void release(void* memory)
+	{
+		if (memory == nullptr)
+			return;
+		BlockHeader* header = header_of(memory);
+		if (header->tracked)
+			live_bytes[header->tag].fetch_sub((int64_t)header->size, std::memory_order_relaxed);
+		std::free(header);
+	}
+#endif
+}
+
+bool allocations_counted()
+{
+#ifdef LOTL_TRACK_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+}
+
+const char* memory_tag_name(MemoryTag tag)
+{
+	int t = (int)tag;
+	return t >= 0 && t < memory_tag_count ? TAG_NAMES[t] : "?";
+}
+
+bool memory_tag_from_name(const char* name, MemoryTag& tag)
+{
+	for (int t = 0; t < memory_tag_count; t++) {
+		const char* tag_name = TAG_NAMES[t];
+		size_t i = 0;
+		while (name[i] != '\0' && tag_name[i] != '\0' && tolower((unsigned char)name[i]) == tag_name[i])
+			i++;
+		if (name[i] == '\0' && tag_name[i] == '\0') {
+			tag = (MemoryTag)t;
+			return true;
+		}
+	}
+	return false;
+}
+
+MemoryScope::MemoryScope(MemoryTag tag)
+	: previous(current_tag)
+{
+	current_tag = tag;
+}
+
+MemoryScope::~MemoryScope()
+{
+	current_tag = previous;
+}
+
+MemoryTracker::MemoryTracker()
+{
+	for (int t = 0; t < memory_tag_count; t++)
+		tags[t].budget_bytes = DEFAULT_BUDGETS[t];
+}
+
+void MemoryTracker::enable()
+{
+	if (!allocations_counted()) {
+		fprintf(stderr, "--track-memory needs a build with LOTL_TRACK_ALLOCATIONS, memory is not tracked\n");
+		return;
+	}
+	tracking.store(true, std::memory_order_relaxed);
+}
+
+bool MemoryTracker::enabled() const
+{
+	return tracking.load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::set_budget(MemoryTag tag, size_t bytes)
+{
+	tags[(int)tag].budget_bytes = bytes;
+	tags[(int)tag].over_budget = false;
+}
+
+void MemoryTracker::end_frame()
+{
+	if (!enabled())
+		return;
+	frames++;
+	for (int t = 0; t < memory_tag_count; t++) {
+		MemoryTagStats& stats = tags[t];
+		stats.live_bytes = live_bytes[t].load(std::memory_order_relaxed);
+		stats.frame_allocations = frame_allocations[t].exchange(0, std::memory_order_relaxed);
+		stats.frame_bytes = frame_bytes[t].exchange(0, std::memory_order_relaxed);
+		stats.total_allocations += stats.frame_allocations;
+		if (stats.live_bytes > stats.peak_bytes)
+			stats.peak_bytes = stats.live_bytes;
+
+		// warns once when the tag goes over its budget, and again if it drops below and
+		// goes over once more
+		bool over = stats.budget_bytes > 0 && stats.live_bytes > (int64_t)stats.budget_bytes;
+		if (over && !stats.over_budget)
+			fprintf(stderr, "Memory budget of %s exceeded: %.0f KB live, budget %.0f KB (frame %llu)\n", TAG_NAMES[t],
+				stats.live_bytes / 1024.0, stats.budget_bytes / 1024.0, (unsigned long long)frames);
+		stats.over_budget = over;
+	}
+}
+
+void MemoryTracker::print_report(FILE* out) const
+{
+	if (!enabled())
+		return;
+	fprintf(out, "Memory by system after %llu frames:\n", (unsigned long long)frames);
+	fprintf(out, "  %-9s %12s %12s %12s %14s %14s\n", "system", "live KB", "peak KB", "budget KB", "allocs/frame", "allocs total");
+	for (int t = 0; t < memory_tag_count; t++) {
+		const MemoryTagStats& stats = tags[t];
+		fprintf(out, "  %-9s %12.1f %12.1f %12.0f %14.1f %14llu%s\n", TAG_NAMES[t], stats.live_bytes / 1024.0, stats.peak_bytes / 1024.0,
+			stats.budget_bytes / 1024.0, frames > 0 ? (double)stats.total_allocations / frames : 0.0,
+			(unsigned long long)stats.total_allocations, stats.over_budget ? "  OVER BUDGET" : "");
+	}
+}
+
+#ifdef LOTL_TRACK_ALLOCATIONS
+void* tracked_malloc(size_t size, MemoryTag tag)
+{
+	return allocate(size, tag);
+}
+
+void* tracked_realloc(void* memory, size_t size)
+{
+	if (memory == nullptr)
+		return allocate(size, current_tag);
+	BlockHeader* header = header_of(memory);
+	void* resized = allocate(size, (MemoryTag)header->tag);
+	if (resized == nullptr)
+		return nullptr;
+	memcpy(resized, memory, header->size < size ? header->size : size);
+	release(memory);
+	return resized;
+}
+
+void tracked_free(void* memory)
+{
+	release(memory);
+}
+
+uint64_t thread_allocations()
+{
+	return allocations;
+}
+
+void* operator new(std::size_t size)
+{
+	allocations++;
+	while (true) {
+		void* memory = allocate(size, current_tag);
+		if (memory != nullptr)
+			return memory;
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+			throw std::bad_alloc();
+		handler();
+	}
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try {
+		return operator new(size);
+	}
+	catch (...) {
+		return nullptr;
+	}
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return operator new(size, std::nothrow);
+}
+
+void operator delete(void* memory) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	release(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	release(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	release(memory);
+}
+#else
+void* tracked_malloc(size_t size, MemoryTag)
+{
+	return std::malloc(size);
+}
+
+void* tracked_realloc(void* memory, size_t size)
+{
+	return std::realloc(memory, size);
+}
+
+void tracked_free(void* memory)
+{
+	std::free(memory);
+}
+
+uint64_t thread_allocations()
+{
+	return 0;
+}
+#endif
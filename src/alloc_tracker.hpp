@@ -0,0 +1,107 @@
+#pragma once
+
+// stlib
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Built with LOTL_TRACK_ALLOCATIONS (the CMake option of the same name, off by default) the
+// game replaces the global operator new and delete to count heap allocations per thread, so
+// code that should not allocate in the steady state (the UI of a frame, see
+// RenderStats::ui_allocations) can be checked. Counting is a thread local increment. Builds
+// without it, the shipped ones, keep the default allocator and count nothing.
+//
+// With the hook, --track-memory also counts the allocations per system: every allocation goes
+// to the MemoryTag of the innermost MemoryScope of its thread (OTHER outside of any), and the
+// tracker keeps the live bytes and the allocations of the frame of every tag, so churn and
+// the memory a system holds on to show up in the performance overlay and the report printed
+// on exit. A tag with a budget warns on the console when its live bytes go over it.
+//
+// Every hooked allocation carries a small header with its size and tag, tracked or not, so the
+// memory allocated before tracking starts can still be freed. ImGui and SDL (the sounds and
+// music) allocate with malloc, they're routed through tracked_malloc() under their own tag
+// while tracking, and so are the images decoded by stb_image.
+
+enum class MemoryTag : uint8_t
+{
+	OTHER = 0,
+	ECS,
+	DIALOGUE,
+	IMAGES,
+	IMGUI,
+	AUDIO,
+	SAVES,
+	BATTLE,
+	TAG_COUNT
+};
+const int memory_tag_count = (int)MemoryTag::TAG_COUNT;
+
+const char* memory_tag_name(MemoryTag tag);
+// The tag with the name (as memory_tag_name(), any case), false if there is none
+bool memory_tag_from_name(const char* name, MemoryTag& tag);
+
+// Allocations of the thread go to the tag while the scope lives
+class MemoryScope
+{
+public:
+	explicit MemoryScope(MemoryTag tag);
+	~MemoryScope();
+	MemoryScope(const MemoryScope&) = delete;
+	MemoryScope& operator=(const MemoryScope&) = delete;
+
+private:
+	MemoryTag previous;
+};
+
+// What was counted for a tag
+struct MemoryTagStats
+{
+	int64_t live_bytes = 0;
+	int64_t peak_bytes = 0;
+	// 0 for no budget
+	size_t budget_bytes = 0;
+	// of the last complete frame
+	uint64_t frame_allocations = 0;
+	uint64_t frame_bytes = 0;
+	uint64_t total_allocations = 0;
+	bool over_budget = false;
+};
+
+class MemoryTracker
+{
+public:
+	MemoryTracker();
+
+	// Starts counting per tag, from main() before any other thread is started. Only warns
+	// without the hook.
+	void enable();
+	bool enabled() const;
+
+	// 0 removes the budget
+	void set_budget(MemoryTag tag, size_t bytes);
+
+	// Moves the counters of the frame to the stats and warns about the budgets that were
+	// exceeded since the last frame. From the main thread, once per frame.
+	void end_frame();
+
+	const MemoryTagStats& stats(MemoryTag tag) const { return tags[(int)tag]; }
+	void print_report(FILE* out) const;
+
+private:
+	MemoryTagStats tags[memory_tag_count];
+	uint64_t frames = 0;
+};
+
+extern MemoryTracker memory_tracker;
+
+// false if the build doesn't have the hook, allocations are not counted at all
+bool allocations_counted();
+
+// malloc, realloc and free for libraries that take allocator functions, counted like
+// operator new (plain malloc, realloc and free without the hook). tracked_realloc() and tracked_free() take the memory of either of them.
+void* tracked_malloc(size_t size, MemoryTag tag);
+void* tracked_realloc(void* memory, size_t size);
+void tracked_free(void* memory);
+
+// Allocations made by the calling thread since it started, 0 without the hook
+uint64_t thread_allocations();
@@ -1,5 +1,10 @@
 // internal
 #include "animation_system.hpp"
+#include "parallel_for.hpp"
+#include "game_clock.hpp"
+
+// sprites advanced per job
+const size_t SPRITE_CHUNK = 512;
 
 void AnimationSystem::step(float elapsed_ms)
 {
@@ -7,10 +12,9 @@ void AnimationSystem::step(float elapsed_ms)
 	// find sprite information and set current frame
 
 	//fprintf(stderr, "elapsed ms: %f, step seconds: %f \n", elapsed_ms, step_seconds);
-	double time = glfwGetTime();
-	for (uint i = 0; i < sprite_container.size(); i++) {
-
-		Sprite& sprite = sprite_container.components[i];
+	double time = game_clock.now();
+	// every sprite only depends on its own state
+	parallel_for(sprite_container, SPRITE_CHUNK, [time](Sprite& sprite, Entity) {
 
 		double frameDuration = sprite.frame_duration; // Time in seconds for each frame
 		if (sprite.last_time == 0.0f) {
@@ -34,6 +38,6 @@ void AnimationSystem::step(float elapsed_ms)
 			sprite.num_frames = 1;
 			sprite.last_time = 0.0f;
 		}
-	}
+	});
 	(void)elapsed_ms; // placeholder to silence unused warning until implemented
 }
@@ -0,0 +1,548 @@
+// Header
+#include "battle_core.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+	bool compareBySpd(const PartyMember& a, const PartyMember& b) {
+		return a.stats.speed > b.stats.speed;
+	}
+}
+
+void BattleCore::loadRod(Durability* rod_durability, const Attack& rod_attack, const Defense& rod_defense)
+{
+	durability = rod_durability;
+	currHealth = durability->current;
+	maxHealth = durability->max;
+	currAttack = (float) rod_attack.damage;
+	currDefense = (float) rod_defense.value;
+}
+
+void BattleCore::loadEnemy(Enemy* battle_enemy)
+{
+	enemy = battle_enemy;
+	enemySpecies = enemy->species;
+	enemyMaxHealth = enemySpecies.health;
+}
+
+void BattleCore::loadParty(const std::vector<PartyMember>& party)
+{
+	// copied into the members of the last battle, their names, skills and descriptions
+	// already have the memory for it after the first battles
+	if (allMembers.empty())
+		allMembers.swap(retiredMembers);
+	allMembers.assign(party.begin(), party.end());
+	updateTurnOrder();
+}
+
+void BattleCore::endBattle()
+{
+	if (retiredMembers.empty())
+		retiredMembers.swap(allMembers);
+	allMembers.clear();
+	rodEffects.clear();
+	effectNames.clear();
+	battleArena.reset();
+}
+
+const char* BattleCore::effectName(const std::string& skill_name)
+{
+	for (const char* name : effectNames) {
+		if (skill_name == name)
+			return name;
+	}
+	char* name = battleArena.allocate_array<char>(skill_name.size() + 1);
+	memcpy(name, skill_name.c_str(), skill_name.size() + 1);
+	effectNames.push_back(name);
+	return name;
+}
+
+void BattleCore::updateTurnOrder()
+{
+	std::sort(allMembers.begin(), allMembers.end(), compareBySpd);
+	int enemyIn = 0;
+	enemy->actionIndex = -1;
+	for (int i = 0; i < allMembers.size(); i++) {
+		if (allMembers[i].stats.speed < enemySpecies.speed && enemyIn == 0) {
+			enemyIn = 1;
+			enemy->actionIndex = i;
+			allMembers[i].actionIndex = i + 1;
+		}
+		else {
+			allMembers[i].actionIndex = i + enemyIn;
+		}
+	}
+	if (enemy->actionIndex == -1)
+		enemy->actionIndex = allMembers.size();
+	currMemberIndex = 0; //here assume at least the main character will be in partyMembers. allMembers should be kept sorted by speed
+}
+
+BattleCore::Turn BattleCore::roundBeginTurn() const
+{
+	//note: make sure currMember here is not the previous acted, but the upcoming character (ie update currMember immediately when previous char's action ends)
+	if (allMembers[currMemberIndex].actionIndex < enemy->actionIndex)
+		return Turn::PLAYER;
+	return Turn::ENEMY;
+}
+
+// TODO: regarding the skills system, i just realized very late that there should be a struct to track the original stat, so overlapping buff types don't scale off the already buffed stat...
+void BattleCore::playerAction(int skillIndex, RngStream& gen)
+{
+	std::uniform_int_distribution<int> dmgDist(-2, 2); // damage has a random range of 4
+	std::uniform_real_distribution<float> critDist(0.f, 1.f); // rand representing crit rate, 0 - 100%
+	const Skill& currSkill = allMembers[currMemberIndex].skills[skillIndex];
+	const char* currSkillName = effectName(currSkill.skill_name);
+	float damage;
+	float chosenAtk = currAttack;
+	if (allMembers[currMemberIndex].name != mc_name)
+		chosenAtk = allMembers[currMemberIndex].stats.attack;
+	if (critDist(gen) < allMembers[currMemberIndex].stats.critical_rate) {
+		dmgVals.textColour = IM_COL32_WHITE;
+		damage = allMembers[currMemberIndex].stats.critical_value * (chosenAtk * currSkill.skill_scale + dmgDist(gen)) - enemySpecies.defense;
+	}
+	else {
+		dmgVals.textColour = battle_dmg_colour;
+		damage = (chosenAtk * currSkill.skill_scale + dmgDist(gen)) - enemySpecies.defense;
+	}
+	if (damage < 1)
+		damage = 1;
+	dmgVals.value = damage;
+	dmgVals.targetPlayer = false;
+	float healingVal = allMembers[currMemberIndex].stats.healing_bonus * currSkill.skill_scale * maxHealth + dmgDist(gen);
+	switch (currSkill.skill_type)
+	{
+		case SKILL_TYPE::ATK:
+			dmgVals.shouldDisplay = true;
+			if (currSkill.skill_name == "Doom") {
+				int multiplier = enemy->currEffects.size();
+				for (const CurrEffect& e : enemy->currEffects) {
+					if (e.effect.type == EFFECT_TYPE::DEBUFF_ALL) {
+						multiplier += 2;
+					}
+				}
+				if (multiplier > 7)
+					multiplier = 7;
+				if (multiplier > 0) {
+					float bonusDmg = multiplier * 0.45 * damage + dmgDist(gen);
+					allMembers[currMemberIndex].followUpDmg.push_back(bonusDmg);
+				}
+			}
+			if (enemySpecies.health > damage) {
+				enemySpecies.health -= damage;
+			}
+			else {
+				enemySpecies.health = 0;
+			}
+			for (float a : allMembers[currMemberIndex].followUpDmg) {
+				if (enemySpecies.health > a) {
+					enemySpecies.health -= a;
+				}
+				else {
+					enemySpecies.health = 0;
+				}
+			}
+			break;
+		case SKILL_TYPE::HEAL:
+			dmgVals.shouldDisplay = true;
+			dmgVals.value = healingVal;
+			dmgVals.targetPlayer = true;
+			dmgVals.textColour = battle_heal_colour;
+			if ((currHealth + healingVal) > maxHealth && (durability->current + healingVal) > durability->max) {
+				currHealth = maxHealth;
+				durability->current = durability->max;
+			}
+			else {
+				currHealth += healingVal;
+				durability->current += healingVal;
+			}
+			break;
+		case SKILL_TYPE::BUFF:
+			dmgVals.shouldDisplay = false;
+			break;
+		default:
+			break;
+	}
+
+	CurrEffect effect;
+	bool hasEffect = false;
+	int effectIndex = -1;
+	float resultStat = 0;
+	switch (currSkill.skill_effect.type) {
+		case EFFECT_TYPE::DEBUFF_ALL:
+			effect = { currSkillName, {currSkill.skill_effect.type, currSkill.skill_effect.num_rounds}, currSkill.effect_scale }; // note in debuff all's case, just record the scaling factor as value cause multiple values are changed
+			hasEffect = false;
+			effectIndex = -1;
+			for (int i = 0; i < enemy->currEffects.size(); i++) {
+				if (strcmp(enemy->currEffects[i].skill_name, currSkillName) == 0) {
+					hasEffect = true;
+					effectIndex = i;
+				}
+			}
+			if (hasEffect) {
+				enemy->currEffects[effectIndex] = effect;
+			}
+			else {
+				enemySpecies.attack = enemySpecies.attack * currSkill.effect_scale;
+				enemySpecies.defense = enemySpecies.defense * currSkill.effect_scale;
+				enemySpecies.speed = enemySpecies.speed * currSkill.effect_scale;
+				enemy->currEffects.push_back(effect);
+			}
+			break;
+		case EFFECT_TYPE::DEBUFF_ATK:
+			effect = { currSkillName, {currSkill.skill_effect.type, currSkill.skill_effect.num_rounds}, currSkill.effect_scale };
+			hasEffect = false;
+			effectIndex = -1;
+			for (int i = 0; i < enemy->currEffects.size(); i++) {
+				if (strcmp(enemy->currEffects[i].skill_name, currSkillName) == 0) {
+					hasEffect = true;
+					effectIndex = i;
+				}
+			}
+			if (hasEffect) {
+				enemy->currEffects[effectIndex] = effect;
+			}
+			else {
+				enemySpecies.attack = enemySpecies.attack * currSkill.effect_scale;
+				enemy->currEffects.push_back(effect);
+			}
+			break;
+		case EFFECT_TYPE::BUFF_ATK:
+			for (int i = 0; i < allMembers.size(); i++) {
+				resultStat = currSkill.effect_scale * allMembers[i].stats.attack;
+				if (currSkill.skill_name == "Determination")
+					resultStat = currAttack * currSkill.effect_scale + allMembers[i].stats.attack;
+				effect = { currSkillName, currSkill.skill_effect, resultStat - allMembers[i].stats.attack };
+				hasEffect = false;
+				effectIndex = -1;
+				for (int j = 0; j < allMembers[i].currEffects.size(); j++) {
+					if (strcmp(allMembers[i].currEffects[j].skill_name, currSkillName) == 0) {
+						hasEffect = true;
+						effectIndex = j;
+					}
+				}
+				if (hasEffect) {
+					//buff already exists, then refresh duration and don't stack buff value
+					if (currSkill.skill_name == "Determination") {
+						int num_rounds = effect.effect.num_rounds + 3;
+						if (num_rounds > 7)
+							num_rounds = 7;
+						allMembers[i].currEffects[effectIndex] = { currSkillName, {currSkill.skill_effect.type, num_rounds }, allMembers[i].currEffects[effectIndex].value };
+					}
+					else {
+						allMembers[i].currEffects[effectIndex] = effect;
+					}
+				}
+				else {
+					allMembers[i].currEffects.push_back(effect);
+					allMembers[i].stats.attack = resultStat;
+				}
+			}
+			break;
+		case EFFECT_TYPE::BUFF_DEF:
+			resultStat = currSkill.effect_scale * currDefense;
+			if (currSkill.skill_name == "Mode: Indestructible") {
+				resultStat = currSkill.effect_scale * 5.f; //this 5 is supposed to be the original def but rn there's no stat for that
+				for (int i = 0; i < rodEffects.size(); i++) {
+					if (strcmp(rodEffects[i].skill_name, "Fortress") == 0) {
+						resultStat += rodEffects[i].effect.num_rounds * 5.f;
+						currDefense -= static_cast<int>(rodEffects[i].value);
+						rodEffects.erase(rodEffects.begin() + i);
+					}
+				}
+			}
+			// this setting is fine and all... but its mainly done because stacking the same buff type is broken rn
+			else if (currSkill.skill_name == "Fortress") {
+				for (int i = 0; i < rodEffects.size(); i++) {
+					if (strcmp(rodEffects[i].skill_name, "Mode: Indestructible") == 0) {
+						return;
+					}
+				}
+			}
+			effect = { currSkillName, currSkill.skill_effect, resultStat - currDefense };
+			hasEffect = false;
+			effectIndex = -1;
+			for (int i = 0; i < rodEffects.size(); i++) {
+				if (strcmp(rodEffects[i].skill_name, currSkillName) == 0) {
+					hasEffect = true;
+					effectIndex = i;
+				}
+			}
+			if (hasEffect) {
+				if (currSkill.skill_name == "Mode: Indestructible") {
+					currDefense -= rodEffects[effectIndex].value;
+					effect.value = 10; //hard coded due to no original stat track
+					currDefense += effect.value;
+				}
+				rodEffects[effectIndex] = effect;
+			}
+			else {
+				rodEffects.push_back(effect);
+				currDefense = resultStat;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+void BattleCore::enemyAction(RngStream& gen)
+{
+	std::uniform_int_distribution<int> dmgDist(-2, 2);
+	std::uniform_real_distribution<float> critDist(0.f, 1.f);
+	std::uniform_real_distribution<float> skillDist(0.f, 1.f);
+
+	int skillIndex = 0;
+	float prob = skillDist(gen);
+	float culmulatedProb = enemy->skills[0].probability;
+	for (int i = 0; i < enemy->skills.size() - 1; i++) {
+		if (prob > culmulatedProb && prob < (enemy->skills[i + 1].probability + culmulatedProb)) {
+			skillIndex = i + 1;
+		}
+		culmulatedProb += enemy->skills[i + 1].probability;
+	}
+	if (enemySpecies.name == "Boss") {
+		if (roundCounter > 15)
+			skillIndex = 3;
+		if (roundCounter == 1)
+			skillIndex = 4;
+		if (enemySpecies.health <= 0.6f * enemyMaxHealth && !bossBalanceUsed) {
+			skillIndex = 5;
+			bossBalanceUsed = true;
+		}
+	}
+	enemySelectedSkill = skillIndex;
+	const Skill& currSkill = enemy->skills[skillIndex];
+	const char* currSkillName = effectName(currSkill.skill_name);
+	float damage;
+	if (critDist(gen) < enemySpecies.critical_rate) {
+		dmgVals.textColour = IM_COL32_WHITE;
+		damage = enemySpecies.critical_value * (currSkill.skill_scale * enemySpecies.attack + dmgDist(gen)) - currDefense;
+	}
+	else {
+		dmgVals.textColour = battle_dmg_colour;
+		damage = (currSkill.skill_scale * enemySpecies.attack + dmgDist(gen)) - currDefense;
+	}
+	if (damage < 1)
+		damage = 1;
+	dmgVals.value = damage;
+	dmgVals.targetPlayer = true;
+	switch (currSkill.skill_type)
+	{
+		case SKILL_TYPE::PERCENTAGE_DMG:
+			damage = currSkill.skill_scale * currHealth;
+			dmgVals.value = damage;
+		case SKILL_TYPE::ATK:
+			dmgVals.shouldDisplay = true;
+			if (currHealth > damage && durability->current > damage) {
+				currHealth -= damage;
+				durability->current -= damage;
+			}
+			else {
+				currHealth = 0.f;
+				durability->current = 0.f;
+			}
+			break;
+		case SKILL_TYPE::DEBUFF:
+			dmgVals.shouldDisplay = false;
+			break;
+		default:
+			break;
+	}
+	switch (currSkill.skill_effect.type) {
+		case EFFECT_TYPE::DEBUFF_SPD:
+			for (int i = 0; i < allMembers.size(); i++) {
+				CurrEffect effect = { currSkillName, currSkill.skill_effect, currSkill.effect_scale * allMembers[i].stats.speed - allMembers[i].stats.speed };
+				bool hasEffect = false;
+				int effectIndex = -1;
+				for (int j = 0; j < allMembers[i].currEffects.size(); j++) {
+					if (strcmp(allMembers[i].currEffects[j].skill_name, currSkillName) == 0) {
+						hasEffect = true;
+						effectIndex = j;
+					}
+				}
+				if (hasEffect) {
+					allMembers[i].currEffects[effectIndex] = effect;
+				}
+				else {
+					allMembers[i].currEffects.push_back(effect);
+					allMembers[i].stats.speed = currSkill.effect_scale * allMembers[i].stats.speed;
+				}
+			}
+			break;
+		case EFFECT_TYPE::DEBUFF_DEF: {
+			CurrEffect effect = { currSkillName, currSkill.skill_effect, currSkill.effect_scale * currDefense - currDefense };
+			bool hasEffect = false;
+			int effectIndex = -1;
+			for (int i = 0; i < rodEffects.size(); i++) {
+				if (strcmp(rodEffects[i].skill_name, currSkillName) == 0) {
+					hasEffect = true;
+					effectIndex = i;
+				}
+			}
+			if (hasEffect) {
+				rodEffects[effectIndex] = effect;
+			}
+			else {
+				rodEffects.push_back(effect);
+				currDefense = currSkill.effect_scale * currDefense;
+			}
+
+			if (currSkill.skill_name == "Dream Transfer") {
+				CurrEffect effectBuff = { currSkillName, {EFFECT_TYPE::BUFF_ATK, currSkill.skill_effect.num_rounds}, -1.f * effect.value };
+				bool hasEffect = false;
+				int effectIndex = -1;
+				for (int i = 0; i < enemy->currEffects.size(); i++) {
+					if (strcmp(enemy->currEffects[i].skill_name, currSkillName) == 0) {
+						hasEffect = true;
+						effectIndex = i;
+					}
+				}
+				if (hasEffect) {
+					enemy->currEffects[effectIndex] = effectBuff;
+				}
+				else {
+					enemy->currEffects.push_back(effectBuff);
+					enemySpecies.attack -= effect.value; // this is minusing a negative, which is a buff to enemy
+				}
+			}
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+BattleCore::Turn BattleCore::nextTurn(int actionIndex)
+{
+	if (enemySpecies.health <= 0.f)
+		return Turn::ENEMY_DEFEATED;
+	else if (currHealth <= 0.f)
+		return Turn::PLAYER_DEFEATED;
+
+	if (actionIndex == allMembers.size()) {
+		roundCounter++;
+		roundUpdate();
+		return Turn::ROUND_OVER;
+	}
+	//if the current ally is not last ally, decide whether player or enemy goes next
+	if (currMemberIndex < allMembers.size() - 1) {
+		// if next ally is faster than enemy or enemy already acted, then player turn. else, enemy turn
+		if (enemy->actionIndex != actionIndex)
+			currMemberIndex++;
+		if (allMembers[currMemberIndex].actionIndex < enemy->actionIndex || enemyActed)
+			return Turn::PLAYER;
+		return Turn::ENEMY;
+	}
+	// if the current ally is the last ally
+	return enemyActed ? Turn::PLAYER : Turn::ENEMY;
+}
+
+void BattleCore::roundUpdate() {
+	for (int i = 0; i < allMembers.size(); i++) {
+		for (int j = 0; j < allMembers[i].currEffects.size(); j++) {
+			allMembers[i].currEffects[j].effect.num_rounds--;
+			CurrEffect temp = allMembers[i].currEffects[j];
+			if (temp.effect.num_rounds == 0) {
+				// note to restore is always -= value. The value is the amount changed, and will be negative if debuff, positive if buff
+				switch (temp.effect.type) {
+					case EFFECT_TYPE::BUFF_ATK:
+						allMembers[i].stats.attack -= static_cast<int>(temp.value);
+						break;
+					case EFFECT_TYPE::DEBUFF_SPD:
+						allMembers[i].stats.speed -= static_cast<int>(temp.value);
+						break;
+					default:
+						break;
+				}
+				allMembers[i].currEffects.erase(allMembers[i].currEffects.begin() + j);
+			}
+		}
+		while (!allMembers[i].followUpDmg.empty()) {
+			allMembers[i].followUpDmg.pop_back();
+		}
+	}
+	for (int i = 0; i < rodEffects.size(); i++) {
+		rodEffects[i].effect.num_rounds--;
+		if (rodEffects[i].effect.num_rounds == 0) {
+			switch (rodEffects[i].effect.type) {
+			case EFFECT_TYPE::DEBUFF_DEF:
+				currDefense -= static_cast<int>(rodEffects[i].value);
+				if (strcmp(rodEffects[i].skill_name, "Dream Transfer") == 0)
+					enemySpecies.attack += rodEffects[i].value; // since this value is negative, enemy attack will decrease here
+				break;
+			case EFFECT_TYPE::BUFF_DEF:
+				currDefense -= static_cast<int>(rodEffects[i].value);
+				break;
+			default:
+				break;
+			}
+			rodEffects.erase(rodEffects.begin() + i);
+		}
+	}
+	for (int i = 0; i < enemy->currEffects.size(); i++) {
+		enemy->currEffects[i].effect.num_rounds--;
+		if (enemy->currEffects[i].effect.num_rounds == 0) {
+			switch (enemy->currEffects[i].effect.type) {
+				case EFFECT_TYPE::DEBUFF_ALL:
+					enemySpecies.attack = static_cast<int>(enemySpecies.attack / enemy->currEffects[i].value);
+					enemySpecies.defense = static_cast<int>(enemySpecies.defense / enemy->currEffects[i].value);
+					enemySpecies.speed = static_cast<int>(enemySpecies.speed / enemy->currEffects[i].value);
+					break;
+				case EFFECT_TYPE::DEBUFF_ATK:
+					enemySpecies.attack = static_cast<int>(enemySpecies.attack / enemy->currEffects[i].value);
+					break;
+				default:
+					break;
+			}
+			enemy->currEffects.erase(enemy->currEffects.begin() + i);
+		}
+	}
+
+	// reconstruct action order, as spd might have been changed due to buffs
+	updateTurnOrder();
+	enemyActed = false;
+}
+
+std::vector<Skill> enemySkills(const FishSpecies& species)
+{
+	if (species.name == "Turtle")
+		return { turtle_clap_clap, turtle_shell_collide, turtle_slowing_atk };
+	if (species.name == "Narwhal")
+		return { narwhal_chant, narwhal_chant_intense, narwhal_dream_transfer };
+	if (species.name == "Boss")
+		return { boss_na, boss_heavy, boss_throw_salmon, boss_execution, boss_field, boss_balance };
+	return { walrus_flop_flop, walrus_flip_flop };
+}
+
+namespace
+{
+	PartyMember makePartyMember(const std::string& name, const std::string& desc, Stats stats, std::vector<Skill> skills, TEXTURE_ASSET_ID battle_id, TEXTURE_ASSET_ID menu_id)
+	{
+		PartyMember member;
+		member.name = name;
+		member.description = desc;
+		member.stats = stats;
+		member.skills = skills;
+		member.texture_id = battle_id;
+		member.menu_texture_id = menu_id;
+		return member;
+	}
+}
+
+PartyMember mcPartyMember()
+{
+	return makePartyMember(mc_name, mc_desc, { 10, 1, 10, 0.05f, 1.5f }, { reel, release, determination, run }, TEXTURE_ASSET_ID::MC_PORTRAIT, TEXTURE_ASSET_ID::MC_PORTRAIT_1);
+}
+
+PartyMember ally1PartyMember()
+{
+	return makePartyMember(ally1_name, ally1_desc, { 15, 0, 15, 0.05f, 1.5f }, { manifest, curse, doom, run }, TEXTURE_ASSET_ID::ALLY1_PORTRAIT, TEXTURE_ASSET_ID::ALLY1);
+}
+
+PartyMember ally2PartyMember()
+{
+	return makePartyMember(ally2_name, ally2_desc, { 10, 1, 5, 0.05f, 1.5f }, { distract, fortress, indestructible, run }, TEXTURE_ASSET_ID::ALLY2_PORTRAIT, TEXTURE_ASSET_ID::ALLY2);
+}
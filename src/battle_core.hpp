@@ -0,0 +1,97 @@
+#pragma once
+
+// stlib
+#include <random>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "components.hpp"
+#include "fixed_vector.hpp"
+#include "linear_arena.hpp"
+#include "rng.hpp"
+
+// Rules of a battle: party and fishing rod stats, the enemy's skills, effects and the turn
+// order. Doesn't touch the registry, rendering or audio, the rod and enemy it fights with
+// are passed in, so battles can be played out without the game (see tools/battle_sim.cpp).
+// BattleSystem drives it from the battle UI and adds the animations and sounds.
+//
+// Once the party is loaded, a turn doesn't allocate: effects and follow-up damage are in
+// FixedVectors, the skill names of the effects are copied once per battle into the battle
+// arena, and the party of the next battle is copied into the members of the last one.
+class BattleCore {
+public:
+	// What happens after an action
+	enum class Turn {
+		PLAYER, // allMembers[currMemberIndex] acts next
+		ENEMY,
+		ROUND_OVER, // effects were counted down, next round starts with roundBeginTurn()
+		ENEMY_DEFEATED,
+		PLAYER_DEFEATED,
+	};
+
+	// Loads the rod at the start of a battle. Damage and healing are applied to both
+	// currHealth and rod_durability, so the rod keeps its durability after the battle.
+	void loadRod(Durability* rod_durability, const Attack& rod_attack, const Defense& rod_defense);
+	void loadEnemy(Enemy* battle_enemy);
+	// Loads the party, the enemy has to be loaded first
+	void loadParty(const std::vector<PartyMember>& party);
+	// Lets go of the party, the rod's effects and the battle arena, the effects of the enemy
+	// point into the arena so it has to be gone too
+	void endBattle();
+
+	// Who acts first in a round
+	Turn roundBeginTurn() const;
+	// allMembers[currMemberIndex] uses one of its skills
+	void playerAction(int skillIndex, RngStream& rng);
+	// The enemy picks a skill (enemySelectedSkill) and uses it
+	void enemyAction(RngStream& rng);
+	// Call once the action of actionIndex in the turn order is done, counts the round down if
+	// it was the last one
+	Turn nextTurn(int actionIndex);
+	void roundUpdate();
+
+	int enemySelectedSkill = -1;
+	bool enemyActed = false;
+	int roundCounter = 1;
+	DmgTextVals dmgVals = { 0, false, battle_dmg_colour, false };
+	//these are rod stats only
+	float currHealth = 0.f;
+	float maxHealth = 0.f;
+	float currAttack = -1;
+	float currDefense = 0.f;
+	FixedVector<CurrEffect, MAX_EFFECTS> rodEffects;
+
+	float enemyMaxHealth = 0.f;
+	std::vector<PartyMember> allMembers;
+	int currMemberIndex = -1;
+	FishSpecies enemySpecies;
+	Enemy* enemy = nullptr;
+	// the boss' "Balance" at 60% health is only used once
+	bool bossBalanceUsed = false;
+
+protected:
+	Durability* durability = nullptr;
+
+	// sorts the party by speed and works out where the enemy goes in between
+	void updateTurnOrder();
+	// The skill name for a CurrEffect, a copy in the battle arena that lasts until endBattle()
+	const char* effectName(const std::string& skill_name);
+
+private:
+	// most distinct skill names with effects in one battle
+	static const size_t MAX_EFFECT_NAMES = 32;
+
+	LinearArena battleArena{ 1024 };
+	FixedVector<const char*, MAX_EFFECT_NAMES> effectNames;
+	// the party of the last battle, to copy the next one into
+	std::vector<PartyMember> retiredMembers;
+};
+
+// Skills of the enemies in battle, by species name
+std::vector<Skill> enemySkills(const FishSpecies& species);
+
+// Party members as they join the party
+PartyMember mcPartyMember();
+PartyMember ally1PartyMember();
+PartyMember ally2PartyMember();
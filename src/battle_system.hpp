@@ -4,8 +4,11 @@
 #include "tiny_ecs_registry.hpp"
 #include "sound_system.hpp"
 #include "common.hpp"
+#include "battle_core.hpp"
 
-class BattleSystem {
+// Runs the battle of the battle screen: loads the rod, enemy and party from the registry into
+// the BattleCore and adds the animations, particles and sounds of the actions
+class BattleSystem : public BattleCore {
 public:
 	enum StateEnum {
 		STATE_PLAYER_TURN = 0,
@@ -36,31 +39,15 @@ public:
 
 	bool initialized;
 	int selectedSkill;
-	int enemySelectedSkill;
-	bool enemyActed;
-	int roundCounter;
-	DmgTextVals dmgVals;
-	//these are rod stats only
-	float currHealth;
-	float maxHealth;
-	float currAttack = -1;
-	float currDefense;
-	std::vector<CurrEffect> rodEffects;
 
-	float enemyMaxHealth;
 	void start(GAME_STATE_ID* current_game_state, SoundSystem* sound_system);
 	void update(float step_ms);
 	void checkRoundOver(int actionIndex);
-	void roundUpdate();
 	void createParticles(AnimeEnum anime);
 	void reset();
 
 	StateEnum curr_battle_state;
 	AnimeEnum selectedAnime;
-	std::vector<PartyMember> allMembers;
-	int currMemberIndex;
-	FishSpecies enemySpecies;
-	Enemy* enemy;
 
 	// reference: https://learnopengl.com/In-Practice/2D-Game/Particles
 	std::vector<Particle> particles;
@@ -68,9 +55,9 @@ public:
 private:
 	GAME_STATE_ID* current_game_state;
 	SoundSystem* sound_system;
-	Durability* durability;
-	Attack* attack;
-	Defense* defense;
+	RngStream rng;
+	// looks of the particles, apart from rng so they don't change how battles play out
+	RngStream particle_rng;
 	void activateSkill();
 	void enemyAction();
 };
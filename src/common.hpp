@@ -20,6 +20,7 @@
 using namespace glm;
 
 #include "tiny_ecs.hpp"
+#include "fixed_vector.hpp"
 #include "../imgui/imgui.h"
 
 // Simple utility functions to avoid mistyping directory name
@@ -127,12 +128,18 @@ struct Effect {
 };
 
 // contains an effect, and also the skill name it came from, and value is the DIFF in stats resulted from this effect
+// the skill name is kept by the battle (BattleCore::effectName()) so effects copy without allocating
 struct CurrEffect {
-	std::string skill_name;
+	const char* skill_name = "";
 	Effect effect;
 	float value;
 };
 
+// most effects one fighter (or the rod) can be under at once, one per skill with an effect
+const size_t MAX_EFFECTS = 8;
+// most follow-up hits of one action
+const size_t MAX_FOLLOW_UPS = 4;
+
 // For party member skills
 struct Skill
 {
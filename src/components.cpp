@@ -1,6 +1,12 @@
 #include "components.hpp"
 #include "render_system.hpp" // for gl_has_errors
 
+#include "alloc_tracker.hpp"
+
+// decoded images are counted under their own tag with --track-memory
+#define STBI_MALLOC(size) tracked_malloc(size, MemoryTag::IMAGES)
+#define STBI_REALLOC(memory, size) tracked_realloc(memory, size)
+#define STBI_FREE(memory) tracked_free(memory)
 #define STB_IMAGE_IMPLEMENTATION
 #include "../ext/stb_image/stb_image.h"
 
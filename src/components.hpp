@@ -1,5 +1,6 @@
 #pragma once
 #include "common.hpp"
+#include "fishing_rules.hpp"
 #include <vector>
 #include <unordered_map>
 #include "../ext/stb_image/stb_image.h"
@@ -79,7 +80,7 @@ struct Enemy
     FishSpecies species;
     std::vector<Skill> skills;
     int actionIndex = -1;
-    std::vector<CurrEffect> currEffects;
+    FixedVector<CurrEffect, MAX_EFFECTS> currEffects;
 };
 
 struct Tile
@@ -171,6 +172,16 @@ struct Motion
     vec2 velocity = {0.f, 0.f};
     vec2 scale = {10.f, 10.f};
 
+    // position at the end of the previous simulation step, rendering blends between it
+    // and position (see FixedTimestep). Entities created during a step have none yet.
+    vec2 previous_position = {0.f, 0.f};
+    bool has_previous_position = false;
+
+    vec2 interpolated_position(float alpha) const
+    {
+        return has_previous_position ? previous_position + (position - previous_position) * alpha : position;
+    }
+
     // have to split the vec2 into floats because the cereal library is extremely
     // allergic to any types besides primitives.
     float posX = position.x;
@@ -263,7 +274,7 @@ struct Collision
 };
 
 struct CatchingBar {
-	float filled = 0.3f;
+	float filled = CATCHING_BAR_START;
 };
 
 // Data structure for toggling debug mode
@@ -271,6 +282,7 @@ struct Debug
 {
     bool in_debug_mode = 0;
     bool in_freeze_mode = 0;
+    bool show_perf_overlay = 0;
 };
 extern Debug debugging;
 
@@ -292,20 +304,23 @@ struct DeathTimer
     float timer_ms = 100.f;
 };
 
-// A timer that will be associated to dying salmon
+// The entity is removed once the timer runs out (shiny spots).
+// timer_ms is the lifetime the WorldSystem timer wheel is started with.
 struct RemoveEntityTimer
 {
     float timer_ms = 30000.f;
 };
 
-// A timer that will be associated to how long it takes to catch the fish
+// A timer that will be associated to how long it takes to catch the fish,
+// counted down by the WorldSystem timer wheel
 struct FishingTimer
 {
     float timer_ms = 3000.f;
     Fish fish;
 };
 
-// A timer that will be associated to how long it takes for next shadow movement
+// A timer that will be associated to how long it takes for next shadow movement,
+// counted down by the WorldSystem timer wheel
 struct ShadowTimer
 {
     float timer_ms = 5000.f;
@@ -588,9 +603,9 @@ struct PartyMember
     Stats stats;
     std::vector <Skill> skills;
     int actionIndex = -1;
-    std::vector<CurrEffect> currEffects;
+    FixedVector<CurrEffect, MAX_EFFECTS> currEffects;
     TEXTURE_ASSET_ID texture_id;
-    std::vector<float> followUpDmg;
+    FixedVector<float, MAX_FOLLOW_UPS> followUpDmg;
     TEXTURE_ASSET_ID menu_texture_id;
 };
 
@@ -0,0 +1,125 @@
+// Header
+#include "fish_collection.hpp"
+
+// stlib
+#include <algorithm>
+
+FishCollection fish_collection;
+
+namespace
+{
+	const CatchRecord NO_CATCHES;
+}
+
+void FishCollection::reserve(int species_id, int lake_id)
+{
+	int species = std::max(species_id + 1, std::max(fish_texture_count, species_count()));
+	if ((int)owned_counts.size() < species)
+		owned_counts.resize(species, 0);
+	if ((int)lakes.size() <= lake_id)
+		lakes.resize(lake_id + 1);
+	for (std::vector<CatchRecord>& lake : lakes) {
+		if ((int)lake.size() < species)
+			lake.resize(species);
+	}
+}
+
+void FishCollection::record_catch(int species_id, int lake_id, int64_t timestamp)
+{
+	if (species_id < 0 || lake_id < 0)
+		return;
+	reserve(species_id, lake_id);
+
+	owned_counts[species_id]++;
+	total_owned++;
+
+	CatchRecord& record = lakes[lake_id][species_id];
+	if (record.caught == 0)
+		record.first_caught = timestamp;
+	record.last_caught = timestamp;
+	record.caught++;
+
+	FishingLog entry;
+	entry.timestamp = timestamp;
+	entry.species_id = species_id;
+	entry.lake_id = lake_id;
+	recent.push_back(entry);
+	if (recent.size() > HISTORY_SIZE)
+		recent.pop_front();
+}
+
+void FishCollection::record_catch(int species_id, int lake_id)
+{
+	// FishingLog stamps itself with the current time
+	record_catch(species_id, lake_id, FishingLog().timestamp);
+}
+
+int FishCollection::sell(int species_id, int count)
+{
+	int sold = std::min(owned(species_id), std::max(count, 0));
+	if (sold == 0)
+		return 0;
+	owned_counts[species_id] -= sold;
+	total_owned -= sold;
+	return sold;
+}
+
+void FishCollection::clear()
+{
+	owned_counts.clear();
+	lakes.clear();
+	recent.clear();
+	total_owned = 0;
+}
+
+void FishCollection::load_legacy(const std::vector<Fish>& fishes, const std::vector<FishingLog>& fishlog)
+{
+	clear();
+	// the log has an entry for every catch, sold fish included
+	for (const FishingLog& entry : fishlog)
+		record_catch(entry.species_id, entry.lake_id, entry.timestamp);
+	for (int& count : owned_counts)
+		count = 0;
+	total_owned = 0;
+	for (const Fish& fish : fishes) {
+		if (fish.species_id < 0)
+			continue;
+		reserve(fish.species_id, std::max(fish.lake_id, 0));
+		owned_counts[fish.species_id]++;
+		total_owned++;
+	}
+}
+
+int FishCollection::owned(int species_id) const
+{
+	if (species_id < 0 || species_id >= species_count())
+		return 0;
+	return owned_counts[species_id];
+}
+
+int FishCollection::owned_species(int* ids) const
+{
+	int count = 0;
+	for (int species_id = 0; species_id < species_count(); species_id++) {
+		if (owned_counts[species_id] > 0)
+			ids[count++] = species_id;
+	}
+	return count;
+}
+
+int FishCollection::caught(int species_id) const
+{
+	int count = 0;
+	for (const std::vector<CatchRecord>& lake : lakes) {
+		if (species_id >= 0 && species_id < (int)lake.size())
+			count += lake[species_id].caught;
+	}
+	return count;
+}
+
+const CatchRecord& FishCollection::record(int species_id, int lake_id) const
+{
+	if (lake_id < 0 || lake_id >= (int)lakes.size() || species_id < 0 || species_id >= (int)lakes[lake_id].size())
+		return NO_CATCHES;
+	return lakes[lake_id][species_id];
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// internal
+#include "components.hpp"
+
+// Catches of one species in one lake
+struct CatchRecord
+{
+	int caught = 0;
+	// milliseconds since the epoch, like FishingLog::timestamp, 0 until the first catch
+	int64_t first_caught = 0;
+	int64_t last_caught = 0;
+
+	template<class Archive>
+	void serialize(Archive & archive)
+	{
+		archive(CEREAL_NVP(caught), CEREAL_NVP(first_caught), CEREAL_NVP(last_caught));
+	}
+};
+
+// The fish the player caught and still owns, kept as counts per species (and per lake for
+// the fishing log) instead of an entity per catch. Catches and sales update it in place, so
+// its size, the save size and the cost of the inventory and fishing log UI only depend on
+// the number of species, not on how many fish were ever caught. The latest catches are
+// also kept one by one, up to HISTORY_SIZE of them.
+class FishCollection
+{
+public:
+	static const size_t HISTORY_SIZE = 64;
+
+	void record_catch(int species_id, int lake_id, int64_t timestamp);
+	void record_catch(int species_id, int lake_id);
+	// Removes up to count owned fish of the species, returns how many there were
+	int sell(int species_id, int count = 1);
+	void clear();
+
+	// Rebuilds the counts from the entity lists of saves of version 1
+	void load_legacy(const std::vector<Fish>& fishes, const std::vector<FishingLog>& fishlog);
+
+	// Fish of the species in the inventory
+	int owned(int species_id) const;
+	int owned_total() const { return total_owned; }
+	// Writes the ids of the species with fish owned to ids, which has room for
+	// species_count() of them, and returns how many there are
+	int owned_species(int* ids) const;
+	// Fish of the species ever caught, in any lake
+	int caught(int species_id) const;
+	const CatchRecord& record(int species_id, int lake_id) const;
+	// Most recent catch last
+	const std::deque<FishingLog>& history() const { return recent; }
+
+	// Species ids go up to species_count() - 1
+	int species_count() const { return (int)owned_counts.size(); }
+
+	template<class Archive>
+	void serialize(Archive & archive)
+	{
+		archive(cereal::make_nvp("owned", owned_counts), cereal::make_nvp("lakes", lakes), cereal::make_nvp("history", recent));
+		total_owned = 0;
+		for (int count : owned_counts)
+			total_owned += count;
+	}
+
+private:
+	void reserve(int species_id, int lake_id);
+
+	// [species_id]
+	std::vector<int> owned_counts;
+	// [lake_id][species_id]
+	std::vector<std::vector<CatchRecord>> lakes;
+	std::deque<FishingLog> recent;
+	int total_owned = 0;
+};
+
+extern FishCollection fish_collection;
@@ -0,0 +1,153 @@
+// Header
+#include "fish_selection.hpp"
+
+// stlib
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// the win chances and waits are integrated numerically on this many steps
+	const int INTEGRATION_STEPS = 4096;
+}
+
+void FishSelectionTable::build(const Lake& lake, bool shiny_spot)
+{
+	species_ids.clear();
+	for (auto& it : lake.id_to_fishable)
+		species_ids.push_back(it.first);
+	// unordered_map order isn't stable, the tables should be
+	std::sort(species_ids.begin(), species_ids.end());
+
+	size_t n = species_ids.size();
+	probabilities.resize(n);
+	win_chances.assign(n, 0.f);
+	alias_keep.assign(n, 1.f);
+	alias.resize(n);
+	wait_quantiles.assign(n * (WAIT_STEPS + 1), 0.f);
+	if (n == 0)
+		return;
+
+	// upper end of each species' wait, same as the old per cast race
+	std::vector<double> max_wait(n);
+	double race_end = 0.0;
+	for (size_t i = 0; i < n; i++) {
+		probabilities[i] = lake.id_to_fishable.at(species_ids[i]).probability;
+		max_wait[i] = probabilities[i];
+		if (shiny_spot && probabilities[i] <= UNCOMMON_FISH)
+			max_wait[i] *= 1.5;
+		if (i == 0 || max_wait[i] < race_end)
+			race_end = max_wait[i];
+	}
+
+	// Species i wins at time t if its wait ends there and every other one is still going:
+	//   density_i(t) = 1 / max_wait[i] * prod_{j != i} (1 - t / max_wait[j]),  t < race_end
+	// Its integral is the win chance, the running integral gives the wait given the win.
+	std::vector<double> cumulative((INTEGRATION_STEPS + 1) * n, 0.0);
+	std::vector<double> previous_density(n, 0.0);
+	double dt = race_end / INTEGRATION_STEPS;
+	for (int k = 0; k <= INTEGRATION_STEPS; k++) {
+		double t = k * dt;
+		for (size_t i = 0; i < n; i++) {
+			double density = 1.0 / max_wait[i];
+			for (size_t j = 0; j < n; j++) {
+				if (j != i)
+					density *= std::max(0.0, 1.0 - t / max_wait[j]);
+			}
+			if (k > 0)
+				cumulative[k * n + i] = cumulative[(k - 1) * n + i] + 0.5 * (density + previous_density[i]) * dt;
+			previous_density[i] = density;
+		}
+	}
+
+	double total = 0.0;
+	for (size_t i = 0; i < n; i++)
+		total += cumulative[INTEGRATION_STEPS * n + i];
+	for (size_t i = 0; i < n; i++)
+		win_chances[i] = (float)(cumulative[INTEGRATION_STEPS * n + i] / total);
+
+	// inverse of the running integral, at the quantile levels of WAIT_STEPS
+	for (size_t i = 0; i < n; i++) {
+		double species_total = cumulative[INTEGRATION_STEPS * n + i];
+		float* quantiles = &wait_quantiles[i * (WAIT_STEPS + 1)];
+		int k = 0;
+		for (int q = 0; q <= WAIT_STEPS; q++) {
+			double level = 1.0 - (1.0 - (double)q / WAIT_STEPS) * (1.0 - (double)q / WAIT_STEPS);
+			double target = species_total * level;
+			while (k < INTEGRATION_STEPS - 1 && cumulative[(k + 1) * n + i] < target)
+				k++;
+			double low = cumulative[k * n + i];
+			double high = cumulative[(k + 1) * n + i];
+			double frac = high > low ? (target - low) / (high - low) : 0.0;
+			quantiles[q] = (float)((k + std::min(1.0, std::max(0.0, frac))) * dt);
+		}
+	}
+
+	// Vose's alias method: columns below the average are topped up by one above it
+	std::vector<double> scaled(n);
+	std::vector<int> small, large;
+	for (size_t i = 0; i < n; i++) {
+		scaled[i] = win_chances[i] * n;
+		alias[i] = (int)i;
+		if (scaled[i] < 1.0)
+			small.push_back((int)i);
+		else
+			large.push_back((int)i);
+	}
+	while (!small.empty() && !large.empty()) {
+		int s = small.back();
+		small.pop_back();
+		int l = large.back();
+		alias_keep[s] = (float)scaled[s];
+		alias[s] = l;
+		scaled[l] -= 1.0 - scaled[s];
+		if (scaled[l] < 1.0) {
+			large.pop_back();
+			small.push_back(l);
+		}
+	}
+	// whatever is left is 1 up to rounding
+	for (int i : small)
+		alias_keep[i] = 1.f;
+	for (int i : large)
+		alias_keep[i] = 1.f;
+}
+
+float FishSelectionTable::win_chance(int species_id) const
+{
+	auto it = std::lower_bound(species_ids.begin(), species_ids.end(), species_id);
+	if (it == species_ids.end() || *it != species_id)
+		return 0.f;
+	return win_chances[it - species_ids.begin()];
+}
+
+FishSelectionTable::Result FishSelectionTable::sample(RngStream& rng) const
+{
+	Result result;
+	if (empty())
+		return result;
+
+	std::uniform_int_distribution<int> column_dist(0, (int)species_ids.size() - 1);
+	std::uniform_real_distribution<float> unit_dist(0.f, 1.f);
+	int column = column_dist(rng);
+	int species = unit_dist(rng) < alias_keep[column] ? column : alias[column];
+
+	// inverse of the quantile levels the table was built at
+	float position = (1.f - std::sqrt(1.f - unit_dist(rng))) * WAIT_STEPS;
+	int step = std::min((int)position, WAIT_STEPS - 1);
+	const float* quantiles = &wait_quantiles[species * (WAIT_STEPS + 1)];
+	float frac = position - step;
+
+	result.species_id = species_ids[species];
+	result.probability = probabilities[species];
+	result.wait = quantiles[step] + (quantiles[step + 1] - quantiles[step]) * frac;
+	return result;
+}
+
+std::unordered_map<int, LakeFishTables> build_lake_fish_tables()
+{
+	std::unordered_map<int, LakeFishTables> tables;
+	for (auto& it : id_to_lake)
+		tables[it.first].build(it.second);
+	return tables;
+}
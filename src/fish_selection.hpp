@@ -0,0 +1,72 @@
+#pragma once
+
+// stlib
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "rng.hpp"
+
+// Picks which fish of a lake bites and after how long.
+// Casting used to race one wait per species, uniform in [0, probability * scale], and take
+// the shortest one. The species that wins that race and its wait don't depend on the
+// scale (the lure/shiny spot charm), only on the probabilities, so both are worked out once
+// per lake: the chance of each species to win goes into a Walker alias table and the wait
+// of each winner into an inverse CDF table. A cast then costs three draws, not one per
+// species, and follows the same distribution.
+class FishSelectionTable
+{
+public:
+	// Resolution of the wait tables, the waits in between are interpolated. The steps get
+	// finer towards the long tail of the waits (quantile 1 - (1 - step / WAIT_STEPS)^2),
+	// where interpolating evenly spaced ones would make the waits noticeably too long.
+	static const int WAIT_STEPS = 128;
+
+	struct Result {
+		int species_id = -1;
+		// probability the species is listed with in the lake (its rarity)
+		float probability = 0.f;
+		// wait in units of the race, i.e. for a scale of 1
+		float wait = 0.f;
+	};
+
+	// With a shiny spot, the common and uncommon fish get 1.5x their probability
+	void build(const Lake& lake, bool shiny_spot);
+
+	bool empty() const { return species_ids.empty(); }
+	size_t size() const { return species_ids.size(); }
+	// Chance of a species to be the one that bites, 0 if it isn't in the lake
+	float win_chance(int species_id) const;
+
+	Result sample(RngStream& rng) const;
+
+private:
+	std::vector<int> species_ids;
+	std::vector<float> probabilities;
+	std::vector<float> win_chances;
+
+	// alias table: column i keeps species i with alias_keep[i], otherwise gives alias[i]
+	std::vector<float> alias_keep;
+	std::vector<int> alias;
+
+	// WAIT_STEPS + 1 quantiles of the wait per species
+	std::vector<float> wait_quantiles;
+};
+
+// Selection tables of a lake, without and with a shiny spot
+struct LakeFishTables
+{
+	FishSelectionTable normal;
+	FishSelectionTable shiny_spot;
+
+	void build(const Lake& lake)
+	{
+		normal.build(lake, false);
+		shiny_spot.build(lake, true);
+	}
+};
+
+// Tables of every lake in id_to_lake, keyed by lake id
+std::unordered_map<int, LakeFishTables> build_lake_fish_tables();
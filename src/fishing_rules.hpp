@@ -0,0 +1,36 @@
+#pragma once
+
+// Numbers of the fishing loop and the shop. They are shared by the game and the
+// fishing_sim tool, so balancing changes made here show up in both.
+
+// a FishSelectionTable wait of 1 (no charm) lasts this long
+const float FISH_WAIT_MS = 2000.f;
+// how long the exclamation mark stays up, the player has to press F before it's gone
+const float CATCH_CHANCE_MS = 1500.f;
+// how long the caught fish is shown
+const float SHOW_FISH_MS = 1500.f;
+
+// Catching bar of the rarer fish: every F press fills it a bit, it drains on its own
+// and the fish is caught once it's full or gets away once it's almost empty
+const float CATCHING_BAR_START = 0.3f;
+const float CATCHING_BAR_PER_PRESS = 0.05f;
+const float CATCHING_BAR_DRAIN_MS = 8000.f; // time it takes to drain a full bar
+const float CATCHING_BAR_ESCAPE = 0.1f;
+
+// fishing rod of a new game and its upgrades in the shop
+const float ROD_START_DURABILITY = 120.f;
+const int ROD_START_ATTACK = 10;
+const int ROD_START_DEFENSE = 5;
+const int ROD_DURABILITY_UPGRADE_PRICE = 14;
+const int ROD_ATTACK_UPGRADE_PRICE = 16;
+const float ROD_DURABILITY_PER_UPGRADE = 5.f;
+const int ROD_ATTACK_PER_UPGRADE = 5;
+// upgrades of each kind needed (with the first ally recruited) before the lake 1 boss shows up
+const float BOSS_UNLOCK_ROD_UPGRADES = 7.f;
+
+// Lures are sold in packs and one is used up per caught fish. Their charm shortens the wait
+// for a bite by that many percent.
+const int LURE_PACK_SIZE = 10;
+const int LURE_TYPES = 2;
+const int LURE_PACK_PRICES[LURE_TYPES] = { 10, 21 };
+const float LURE_CHARMS[LURE_TYPES] = { 5.f, 10.f };
@@ -0,0 +1,38 @@
+#pragma once
+
+// Turns the variable time between rendered frames into a whole number of fixed simulation
+// steps. Whatever doesn't add up to a full step is carried over to the next frame, and
+// alpha() tells the renderer how far it is between the last two simulated states.
+//
+//     int steps = timestep.advance(elapsed_ms);
+//     for (int i = 0; i < steps; i++)
+//         simulate(FixedTimestep::STEP_MS);
+//     render(timestep.alpha());
+class FixedTimestep
+{
+public:
+	static constexpr float STEP_MS = 1000.f / 120.f;
+	// If a frame takes longer than this many steps the simulation slows down instead of
+	// trying to catch up, which would make the next frame even slower
+	static const int MAX_STEPS_PER_FRAME = 12;
+
+	// Returns the number of steps to simulate for elapsed_ms of wall time
+	int advance(float elapsed_ms)
+	{
+		accumulator_ms += elapsed_ms;
+		int steps = (int)(accumulator_ms / STEP_MS);
+		if (steps > MAX_STEPS_PER_FRAME) {
+			steps = MAX_STEPS_PER_FRAME;
+			accumulator_ms = 0.f;
+		}
+		else
+			accumulator_ms -= steps * STEP_MS;
+		return steps;
+	}
+
+	// Fraction of a step the rendered frame is ahead of the last simulated state, in [0, 1)
+	float alpha() const { return accumulator_ms / STEP_MS; }
+
+private:
+	float accumulator_ms = 0.f;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+// stlib
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+// A vector with its elements inline and a capacity fixed at compile time, for the short
+// lists of a battle that fill up and empty every round (effects, follow-up damage), so they
+// never go to the heap. Pushing onto a full one asserts and the element is dropped.
+//
+// Elements are assigned rather than constructed, T needs to be default constructible and
+// removed elements are reset to T().
+template<typename T, size_t N>
+class FixedVector
+{
+public:
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	bool full() const { return count == N; }
+	static size_t capacity() { return N; }
+
+	T& operator[](size_t i) { assert(i < count); return items[i]; }
+	const T& operator[](size_t i) const { assert(i < count); return items[i]; }
+	T& back() { assert(count > 0); return items[count - 1]; }
+	const T& back() const { assert(count > 0); return items[count - 1]; }
+
+	T* begin() { return items; }
+	T* end() { return items + count; }
+	const T* begin() const { return items; }
+	const T* end() const { return items + count; }
+
+	// false if it's full
+	bool push_back(const T& item)
+	{
+		assert(count < N && "FixedVector is full");
+		if (count == N)
+			return false;
+		items[count++] = item;
+		return true;
+	}
+
+	void pop_back()
+	{
+		assert(count > 0);
+		items[--count] = T();
+	}
+
+	// Removes the element, the ones after it move up. Returns where the next one is now.
+	T* erase(T* position)
+	{
+		assert(position >= begin() && position < end());
+		std::move(position + 1, end(), position);
+		pop_back();
+		return position;
+	}
+
+	void clear()
+	{
+		while (count > 0)
+			pop_back();
+	}
+
+private:
+	T items[N] = {};
+	size_t count = 0;
+};
@@ -0,0 +1,168 @@
+// Header
+#include "frame_profiler.hpp"
+
+// stlib
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+FrameProfiler frame_profiler;
+
+FrameProfiler::FrameProfiler()
+	: origin(Clock::now())
+	, owner_thread(std::this_thread::get_id())
+{
+	frames[0].index = 0;
+	frames[0].start_us = 0.0;
+	frames[0].duration_us = 0.0;
+	frames[0].zone_count = 0;
+	frames[0].gpu_zone_count = 0;
+}
+
+double FrameProfiler::now_us() const
+{
+	return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - origin).count() / 1000.0;
+}
+
+void FrameProfiler::begin_frame()
+{
+	Frame& frame = frames[current];
+	frame.index = frame_index;
+	frame.start_us = now_us();
+	frame.duration_us = 0.0;
+	frame.zone_count = 0;
+	frame.gpu_zone_count = 0;
+	depth = 0;
+}
+
+void FrameProfiler::end_frame()
+{
+	Frame& frame = frames[current];
+	frame.duration_us = now_us() - frame.start_us;
+
+	// zones left open (shouldn't happen with ProfileScope) are closed at the frame end
+	while (depth > 0)
+		end_zone();
+
+	frame_index++;
+	current = (current + 1) % MAX_FRAMES;
+	if (num_completed < MAX_FRAMES)
+		num_completed++;
+}
+
+void FrameProfiler::begin_zone(const char* name)
+{
+	if (!enabled || std::this_thread::get_id() != owner_thread)
+		return;
+	assert(depth < MAX_DEPTH && "FrameProfiler zones nested too deep");
+	Frame& frame = frames[current];
+	int zone_index = -1;
+	if (frame.zone_count < MAX_ZONES) {
+		zone_index = frame.zone_count++;
+		Zone& zone = frame.zones[zone_index];
+		zone.name = name;
+		zone.depth = depth;
+		zone.start_us = now_us();
+		zone.duration_us = 0.0;
+	}
+	open_zones[depth++] = zone_index;
+}
+
+void FrameProfiler::end_zone()
+{
+	if (!enabled || std::this_thread::get_id() != owner_thread || depth == 0)
+		return;
+	int zone_index = open_zones[--depth];
+	if (zone_index >= 0) {
+		Zone& zone = frames[current].zones[zone_index];
+		zone.duration_us = now_us() - zone.start_us;
+	}
+}
+
+int FrameProfiler::completed_frames() const
+{
+	return num_completed;
+}
+
+const FrameProfiler::Frame& FrameProfiler::completed_frame(int frames_ago) const
+{
+	assert(frames_ago >= 0 && frames_ago < num_completed);
+	return frames[(current - 1 - frames_ago + MAX_FRAMES) % MAX_FRAMES];
+}
+
+double FrameProfiler::zone_ms(const Frame& frame, const char* name) const
+{
+	double total_us = 0.0;
+	for (int i = 0; i < frame.zone_count; i++) {
+		const Zone& zone = frame.zones[i];
+		if (zone.name == name || strcmp(zone.name, name) == 0)
+			total_us += zone.duration_us;
+	}
+	return total_us / 1000.0;
+}
+
+void FrameProfiler::add_gpu_zone(unsigned long long index, const char* name, double duration_us)
+{
+	if (index > frame_index || frame_index - index > (unsigned long long)num_completed)
+		return;
+	int slot = (int)((current - (int)(frame_index - index) + MAX_FRAMES) % MAX_FRAMES);
+	Frame& frame = frames[slot];
+	if (frame.index != index || frame.gpu_zone_count >= MAX_GPU_ZONES)
+		return;
+	frame.gpu_zones[frame.gpu_zone_count++] = { name, duration_us };
+}
+
+double FrameProfiler::gpu_zone_ms(const Frame& frame, const char* name) const
+{
+	double total_us = -1.0;
+	for (int i = 0; i < frame.gpu_zone_count; i++) {
+		const GpuZone& zone = frame.gpu_zones[i];
+		if (zone.name == name || strcmp(zone.name, name) == 0)
+			total_us = (total_us < 0.0 ? 0.0 : total_us) + zone.duration_us;
+	}
+	return total_us < 0.0 ? -1.0 : total_us / 1000.0;
+}
+
+bool FrameProfiler::write_chrome_trace(const std::string& path) const
+{
+	std::ofstream os(path);
+	if (!os) {
+		fprintf(stderr, "Could not write frame trace to %s\n", path.c_str());
+		return false;
+	}
+
+	// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+	// complete events ("ph": "X") carry their own duration, so nesting is implied by time
+	os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n";
+	os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}";
+	char line[256];
+	for (int i = num_completed - 1; i >= 0; i--) {
+		const Frame& frame = completed_frame(i);
+		snprintf(line, sizeof(line), ",\n{\"name\":\"Frame %llu\",\"cat\":\"frame\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+			frame.index, frame.start_us, frame.duration_us);
+		os << line;
+		for (int z = 0; z < frame.zone_count; z++) {
+			const Zone& zone = frame.zones[z];
+			snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"system\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":1}",
+				zone.name, zone.start_us, zone.duration_us);
+			os << line;
+		}
+		// timer queries only give durations, so GPU passes are drawn starting at the CPU zone that issued them
+		for (int z = 0; z < frame.gpu_zone_count; z++) {
+			const GpuZone& gpu_zone = frame.gpu_zones[z];
+			double start_us = frame.start_us;
+			for (int c = 0; c < frame.zone_count; c++) {
+				if (strcmp(frame.zones[c].name, gpu_zone.name) == 0) {
+					start_us = frame.zones[c].start_us;
+					break;
+				}
+			}
+			snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"gpu\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":2}",
+				gpu_zone.name, start_us, gpu_zone.duration_us);
+			os << line;
+		}
+	}
+	os << "\n]}\n";
+	return true;
+}
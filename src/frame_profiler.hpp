@@ -0,0 +1,105 @@
+#pragma once
+
+// stlib
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Lightweight per-frame CPU profiler.
+// Every frame is split into named zones (one per system / render pass) that are kept in a
+// fixed size ring buffer, so recording never allocates. The last MAX_FRAMES frames can be
+// dumped in the Chrome trace_event format, which chrome://tracing and Perfetto both open.
+//
+// Zone names must be string literals (or otherwise outlive the profiler), only the
+// pointer is stored. Use PROFILE_ZONE("name") at the top of a scope to time it.
+// Only zones of the thread that created the profiler (the main thread) are recorded,
+// the ones of job system workers are ignored.
+class FrameProfiler
+{
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	static const int MAX_FRAMES = 256;
+	static const int MAX_ZONES = 128; // per frame, extra zones are dropped
+	static const int MAX_DEPTH = 16;
+	static const int MAX_GPU_ZONES = 16;
+
+	struct Zone {
+		const char* name;
+		int depth;
+		double start_us; // relative to the profiler creation
+		double duration_us;
+	};
+
+	// GPU time of a render pass, measured with timer queries (see gpu_profiler.hpp)
+	struct GpuZone {
+		const char* name;
+		double duration_us;
+	};
+
+	struct Frame {
+		unsigned long long index;
+		double start_us;
+		double duration_us;
+		int zone_count;
+		Zone zones[MAX_ZONES];
+		int gpu_zone_count;
+		GpuZone gpu_zones[MAX_GPU_ZONES];
+	};
+
+	FrameProfiler();
+
+	void begin_frame();
+	void end_frame();
+
+	void begin_zone(const char* name);
+	void end_zone();
+
+	// Number of completed frames currently held in the ring buffer
+	int completed_frames() const;
+	// frames_ago = 0 is the most recently completed frame
+	const Frame& completed_frame(int frames_ago) const;
+	// Total time spent in all zones with the given name during a frame
+	double zone_ms(const Frame& frame, const char* name) const;
+
+	// Index of the frame being recorded
+	unsigned long long current_frame_index() const { return frame_index; }
+	// GPU results arrive a few frames late, this attaches one to the frame it was measured in.
+	// Ignored if that frame already left the ring buffer.
+	void add_gpu_zone(unsigned long long index, const char* name, double duration_us);
+	// Total GPU time of the zones with the given name during a frame, -1 if none was measured
+	double gpu_zone_ms(const Frame& frame, const char* name) const;
+
+	// Writes every frame in the ring buffer as Chrome trace_event JSON
+	bool write_chrome_trace(const std::string& path) const;
+
+	double now_us() const;
+
+	bool enabled = true;
+
+private:
+	Frame frames[MAX_FRAMES];
+	int current = 0; // frame being recorded
+	int num_completed = 0;
+	unsigned long long frame_index = 0;
+
+	int open_zones[MAX_DEPTH]; // indices into the current frame's zones, -1 if dropped
+	int depth = 0;
+
+	Clock::time_point origin;
+	std::thread::id owner_thread;
+};
+
+extern FrameProfiler frame_profiler;
+
+// Times the enclosing scope as a zone of the current frame
+class ProfileScope
+{
+public:
+	ProfileScope(const char* name) { frame_profiler.begin_zone(name); }
+	~ProfileScope() { frame_profiler.end_zone(); }
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileScope PROFILE_CONCAT(profile_zone_, __LINE__)(name)
@@ -0,0 +1,4 @@
+// Header
+#include "game_clock.hpp"
+
+GameClock game_clock;
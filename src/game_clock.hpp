@@ -0,0 +1,17 @@
+#pragma once
+
+// Time the game has been running, advanced by main() by FixedTimestep::STEP_MS with every
+// simulation step. Unlike glfwGetTime() it only depends on the number of steps, so with the
+// same inputs (--frame-ms, input replays) animations and banners timed with it play out the
+// same on every run.
+class GameClock
+{
+public:
+	void advance(float elapsed_ms) { seconds += elapsed_ms / 1000.0; }
+	double now() const { return seconds; }
+
+private:
+	double seconds = 0.0;
+};
+
+extern GameClock game_clock;
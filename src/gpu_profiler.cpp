@@ -0,0 +1,73 @@
+// Header
+#include "gpu_profiler.hpp"
+
+// stlib
+#include <cassert>
+
+GpuProfiler gpu_profiler;
+
+void GpuProfiler::init()
+{
+	for (Slot& slot : slots)
+		glGenQueries(MAX_ZONES, slot.queries);
+	gl_has_errors();
+	initialized = true;
+}
+
+void GpuProfiler::destroy()
+{
+	if (!initialized)
+		return;
+	for (Slot& slot : slots)
+		glDeleteQueries(MAX_ZONES, slot.queries);
+	initialized = false;
+}
+
+void GpuProfiler::begin_frame()
+{
+	if (!initialized)
+		return;
+	assert(!zone_open && "GPU zone still open at the start of a frame");
+
+	current = (current + 1) % FRAMES_IN_FLIGHT;
+	Slot& slot = slots[current];
+	if (slot.pending) {
+		// results are only read if the whole frame is done, otherwise the frame is dropped
+		// instead of blocking on glGetQueryObject
+		GLint available = 0;
+		if (slot.zone_count > 0)
+			glGetQueryObjectiv(slot.queries[slot.zone_count - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available) {
+			for (int i = 0; i < slot.zone_count; i++) {
+				GLuint64 elapsed_ns = 0;
+				glGetQueryObjectui64v(slot.queries[i], GL_QUERY_RESULT, &elapsed_ns);
+				frame_profiler.add_gpu_zone(slot.frame_index, slot.names[i], (double)elapsed_ns / 1000.0);
+			}
+		}
+	}
+	slot.frame_index = frame_profiler.current_frame_index();
+	slot.zone_count = 0;
+	slot.pending = false;
+}
+
+void GpuProfiler::begin_zone(const char* name)
+{
+	Slot& slot = slots[current];
+	if (!initialized || !frame_profiler.enabled || slot.zone_count >= MAX_ZONES)
+		return;
+	assert(!zone_open && "GPU zones can't be nested");
+	slot.names[slot.zone_count] = name;
+	glBeginQuery(GL_TIME_ELAPSED, slot.queries[slot.zone_count]);
+	zone_open = true;
+}
+
+void GpuProfiler::end_zone()
+{
+	if (!zone_open)
+		return;
+	Slot& slot = slots[current];
+	glEndQuery(GL_TIME_ELAPSED);
+	slot.zone_count++;
+	slot.pending = true;
+	zone_open = false;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// internal
+#include "common.hpp"
+#include "frame_profiler.hpp"
+
+// Measures the GPU time of render passes with GL_TIME_ELAPSED queries.
+// Queries of a frame are read back FRAMES_IN_FLIGHT frames later, when the GPU has long
+// finished them, so the CPU never waits on the driver. Results are attached to the frame
+// they were issued in through frame_profiler.add_gpu_zone(), which makes them show up in
+// the perf overlay and the Chrome trace next to the CPU zones of the same name.
+//
+// GL_TIME_ELAPSED queries can't be nested, so GPU zones must be sequential.
+class GpuProfiler
+{
+public:
+	static const int FRAMES_IN_FLIGHT = 4;
+	static const int MAX_ZONES = FrameProfiler::MAX_GPU_ZONES;
+
+	// Creates the query objects, needs a current GL context
+	void init();
+	void destroy();
+
+	// Collects the results of the frame that used this slot before and starts a new one
+	void begin_frame();
+
+	void begin_zone(const char* name);
+	void end_zone();
+
+private:
+	struct Slot {
+		unsigned long long frame_index = 0;
+		int zone_count = 0;
+		bool pending = false;
+		const char* names[MAX_ZONES];
+		GLuint queries[MAX_ZONES];
+	};
+
+	Slot slots[FRAMES_IN_FLIGHT];
+	int current = 0;
+	bool zone_open = false;
+	bool initialized = false;
+};
+
+extern GpuProfiler gpu_profiler;
+
+// Times the enclosing scope on the GPU
+class GpuProfileScope
+{
+public:
+	GpuProfileScope(const char* name) { gpu_profiler.begin_zone(name); }
+	~GpuProfileScope() { gpu_profiler.end_zone(); }
+};
+
+#define GPU_PROFILE_ZONE(name) GpuProfileScope PROFILE_CONCAT(gpu_profile_zone_, __LINE__)(name)
@@ -0,0 +1,290 @@
+// Header
+#include "input_queue.hpp"
+
+// stlib
+#include <cmath>
+#include <cstring>
+
+// internal
+#include "../imgui/imgui.h"
+
+InputQueue input_queue;
+
+namespace
+{
+	const char MAGIC[8] = { 'L', 'O', 'T', 'L', 'I', 'N', 'P', 'T' };
+	const uint32_t VERSION = 2;
+	// marks the last recorded step, after its tick delta
+	const uint8_t END_OF_RECORDING = 0xff;
+	// marks the end of a frame, after the tick delta to the step that comes after it
+	const uint8_t END_OF_FRAME = 0xfe;
+	// positions are stored in 1/8 pixels
+	const float POSITION_SCALE = 8.f;
+
+	void put_u8(std::vector<uint8_t>& out, uint8_t value)
+	{
+		out.push_back(value);
+	}
+
+	void put_varint(std::vector<uint8_t>& out, uint64_t value)
+	{
+		while (value >= 0x80) {
+			out.push_back((uint8_t)(value | 0x80));
+			value >>= 7;
+		}
+		out.push_back((uint8_t)value);
+	}
+
+	void put_signed(std::vector<uint8_t>& out, int64_t value)
+	{
+		put_varint(out, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+	}
+
+	void put_fixed(std::vector<uint8_t>& out, uint64_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; i++)
+			out.push_back((uint8_t)(value >> (8 * i)));
+	}
+
+	struct Reader {
+		const std::vector<uint8_t>& data;
+		size_t pos = 0;
+		bool ok = true;
+
+		explicit Reader(const std::vector<uint8_t>& data) : data(data) {}
+
+		uint8_t u8()
+		{
+			if (pos >= data.size()) {
+				ok = false;
+				return 0;
+			}
+			return data[pos++];
+		}
+
+		uint64_t varint()
+		{
+			uint64_t value = 0;
+			for (int shift = 0; shift < 64 && ok; shift += 7) {
+				uint8_t byte = u8();
+				value |= (uint64_t)(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+					return value;
+			}
+			ok = false;
+			return 0;
+		}
+
+		int64_t signed_varint()
+		{
+			uint64_t value = varint();
+			return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+		}
+
+		uint64_t fixed(int bytes)
+		{
+			uint64_t value = 0;
+			for (int i = 0; i < bytes; i++)
+				value |= (uint64_t)u8() << (8 * i);
+			return value;
+		}
+	};
+}
+
+InputQueue::~InputQueue()
+{
+	stop_recording();
+}
+
+bool InputQueue::start_recording(const std::string& path, uint64_t seed, float step_ms)
+{
+	stop_recording();
+	record_file = fopen(path.c_str(), "wb");
+	if (record_file == nullptr) {
+		fprintf(stderr, "Could not open %s to record the input\n", path.c_str());
+		return false;
+	}
+	std::vector<uint8_t> header(MAGIC, MAGIC + sizeof(MAGIC));
+	put_fixed(header, VERSION, 4);
+	put_fixed(header, seed, 8);
+	uint32_t step_bits;
+	memcpy(&step_bits, &step_ms, sizeof(step_bits));
+	put_fixed(header, step_bits, 4);
+	fwrite(header.data(), 1, header.size(), record_file);
+	last_written_tick = current_tick;
+	return true;
+}
+
+void InputQueue::stop_recording()
+{
+	if (record_file == nullptr)
+		return;
+	std::vector<uint8_t> out;
+	put_varint(out, current_tick - last_written_tick);
+	put_u8(out, END_OF_RECORDING);
+	fwrite(out.data(), 1, out.size(), record_file);
+	fclose(record_file);
+	record_file = nullptr;
+}
+
+bool InputQueue::load_replay(const std::string& path)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		fprintf(stderr, "Could not open the input recording %s\n", path.c_str());
+		return false;
+	}
+	std::vector<uint8_t> data;
+	uint8_t buffer[4096];
+	size_t read;
+	while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+		data.insert(data.end(), buffer, buffer + read);
+	fclose(file);
+
+	if (data.size() < sizeof(MAGIC) || memcmp(data.data(), MAGIC, sizeof(MAGIC)) != 0) {
+		fprintf(stderr, "%s is not an input recording\n", path.c_str());
+		return false;
+	}
+	Reader reader(data);
+	reader.pos = sizeof(MAGIC);
+	uint32_t version = (uint32_t)reader.fixed(4);
+	if (version != VERSION) {
+		fprintf(stderr, "%s is an input recording of version %u, this build plays version %u\n", path.c_str(), version, VERSION);
+		return false;
+	}
+	recorded_seed = reader.fixed(8);
+	uint32_t step_bits = (uint32_t)reader.fixed(4);
+	memcpy(&recorded_step_ms, &step_bits, sizeof(step_bits));
+
+	replay_events.clear();
+	frame_ends.clear();
+	uint32_t tick = 0;
+	bool ended = false;
+	while (reader.ok && reader.pos < data.size()) {
+		tick += (uint32_t)reader.varint();
+		uint8_t type = reader.u8();
+		if (type == END_OF_RECORDING) {
+			ended = true;
+			break;
+		}
+		if (type == END_OF_FRAME) {
+			frame_ends.push_back(tick);
+			continue;
+		}
+		InputEvent event;
+		event.tick = tick;
+		event.type = (InputEvent::Type)type;
+		switch (event.type) {
+			case InputEvent::KEY:
+			case InputEvent::MOUSE_BUTTON:
+				event.code = (int)reader.signed_varint();
+				event.action = reader.u8();
+				event.mods = reader.u8();
+				break;
+			case InputEvent::MOUSE_MOVE:
+			case InputEvent::SCROLL:
+				event.x = reader.signed_varint() / POSITION_SCALE;
+				event.y = reader.signed_varint() / POSITION_SCALE;
+				break;
+			default:
+				reader.ok = false;
+				break;
+		}
+		if (reader.ok)
+			replay_events.push_back(event);
+	}
+	if (!reader.ok)
+		fprintf(stderr, "%s is cut off or damaged, replaying the %zu events before that\n", path.c_str(), replay_events.size());
+	else if (!ended)
+		fprintf(stderr, "%s has no end marker (the game didn't quit normally), replaying up to the last event\n", path.c_str());
+
+	replay = true;
+	replay_next = 0;
+	replay_frame = 0;
+	// without the end marker the step of the last event still has to run
+	end_tick = ended ? tick : tick + 1;
+	current_tick = 0;
+	return true;
+}
+
+int InputQueue::replay_frame_steps() const
+{
+	if (replay_frame >= frame_ends.size())
+		return 1;
+	return (int)(frame_ends[replay_frame] - current_tick);
+}
+
+void InputQueue::end_frame()
+{
+	if (replay) {
+		if (replay_frame < frame_ends.size())
+			replay_frame++;
+		return;
+	}
+	if (record_file == nullptr)
+		return;
+	std::vector<uint8_t> out;
+	put_varint(out, current_tick - last_written_tick);
+	last_written_tick = current_tick;
+	put_u8(out, END_OF_FRAME);
+	fwrite(out.data(), 1, out.size(), record_file);
+}
+
+void InputQueue::push(InputEvent event)
+{
+	if (replay)
+		return;
+	event.tick = current_tick;
+	// only the last cursor position of a step matters
+	if (event.type == InputEvent::MOUSE_MOVE && pending.size() > pending_next) {
+		InputEvent& last = pending.back();
+		if (last.type == InputEvent::MOUSE_MOVE && last.tick == event.tick) {
+			last = event;
+			return;
+		}
+	}
+	pending.push_back(event);
+}
+
+void InputQueue::write(const InputEvent& event)
+{
+	std::vector<uint8_t> out;
+	put_varint(out, event.tick - last_written_tick);
+	last_written_tick = event.tick;
+	put_u8(out, (uint8_t)event.type);
+	switch (event.type) {
+		case InputEvent::KEY:
+		case InputEvent::MOUSE_BUTTON:
+			put_signed(out, event.code);
+			put_u8(out, (uint8_t)event.action);
+			put_u8(out, (uint8_t)event.mods);
+			break;
+		case InputEvent::MOUSE_MOVE:
+		case InputEvent::SCROLL:
+			put_signed(out, (int64_t)std::lround(event.x * POSITION_SCALE));
+			put_signed(out, (int64_t)std::lround(event.y * POSITION_SCALE));
+			break;
+	}
+	fwrite(out.data(), 1, out.size(), record_file);
+}
+
+void InputQueue::feed_imgui(const InputEvent& event)
+{
+	// the game's UI only uses the mouse
+	ImGuiIO& io = ImGui::GetIO();
+	switch (event.type) {
+		case InputEvent::MOUSE_MOVE:
+			io.AddMousePosEvent(event.x, event.y);
+			break;
+		case InputEvent::MOUSE_BUTTON:
+			// 1 is GLFW_PRESS, 2 (GLFW_REPEAT) doesn't happen for buttons
+			if (event.code >= 0 && event.code < ImGuiMouseButton_COUNT)
+				io.AddMouseButtonEvent(event.code, event.action == 1);
+			break;
+		case InputEvent::SCROLL:
+			io.AddMouseWheelEvent(event.x, event.y);
+			break;
+		default:
+			break;
+	}
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// One input of the player, stamped with the simulation step it is handled before
+struct InputEvent
+{
+	enum Type : uint8_t {
+		KEY = 0,
+		MOUSE_BUTTON = 1,
+		MOUSE_MOVE = 2,
+		SCROLL = 3,
+	};
+
+	uint32_t tick = 0;
+	Type type = KEY;
+	int code = 0; // GLFW key or mouse button
+	int action = 0; // GLFW_PRESS, GLFW_RELEASE or GLFW_REPEAT
+	int mods = 0;
+	float x = 0.f; // cursor position or scroll offset
+	float y = 0.f;
+};
+
+// Input of the GLFW callbacks is queued here and handed to the game at the start of the
+// next simulation step, so it always lands on a whole step and can be recorded and played
+// back exactly.
+//
+// A recording is a small binary file: a header with the master seed of the RNG streams
+// and the step length, then the events and the end of every frame with their ticks as
+// varint deltas. The UI acts once per frame, after the steps of the frame, so a replay
+// takes as many steps in every frame as the recording did. With the same seed that brings
+// the game through the same states as the recorded session (--record=path and
+// --replay=path on the command line).
+//
+// While recording or replaying Dear ImGui gets its mouse input from the queue too
+// (feed_imgui()), so a click reaches the UI in the same frame in both runs.
+class InputQueue
+{
+public:
+	~InputQueue();
+
+	// Writes every dispatched event to path until stop_recording()
+	bool start_recording(const std::string& path, uint64_t seed, float step_ms);
+	void stop_recording();
+	// Loads a recording, from then on only its events are dispatched
+	bool load_replay(const std::string& path);
+
+	bool recording() const { return record_file != nullptr; }
+	bool replaying() const { return replay; }
+	// seed and step length the replayed session was recorded with
+	uint64_t replay_seed() const { return recorded_seed; }
+	float replay_step_ms() const { return recorded_step_ms; }
+	// all recorded frames were played back and the last recorded step is done
+	bool replay_finished() const { return replay && replay_frame >= frame_ends.size() && current_tick >= end_tick; }
+	// Steps the current frame of the replay takes, one per frame past the recorded ones
+	int replay_frame_steps() const;
+	// ImGui is fed from the queue instead of its own GLFW callbacks
+	bool feeds_imgui() const { return replay || recording(); }
+
+	// From the GLFW callbacks, ignored while replaying
+	void push(InputEvent event);
+
+	// Calls fn(event) for the events of the current step in the order they came in
+	template <class Fn>
+	void dispatch(Fn fn)
+	{
+		std::vector<InputEvent>& events = replay ? replay_events : pending;
+		size_t& next = replay ? replay_next : pending_next;
+		while (next < events.size() && events[next].tick <= current_tick) {
+			InputEvent event = events[next++];
+			event.tick = current_tick;
+			if (recording())
+				write(event);
+			fn(event);
+		}
+		if (!replay && next == events.size()) {
+			pending.clear();
+			pending_next = 0;
+		}
+	}
+	// Call after every simulation step
+	void next_tick() { current_tick++; }
+	// Call after the steps of every frame
+	void end_frame();
+	uint32_t tick() const { return current_tick; }
+
+	// Passes an event on to Dear ImGui, which doesn't see the GLFW callbacks while recording
+	// or replaying
+	static void feed_imgui(const InputEvent& event);
+
+private:
+	void write(const InputEvent& event);
+
+	uint32_t current_tick = 0;
+	std::vector<InputEvent> pending;
+	size_t pending_next = 0;
+
+	FILE* record_file = nullptr;
+	uint32_t last_written_tick = 0;
+
+	bool replay = false;
+	std::vector<InputEvent> replay_events;
+	size_t replay_next = 0;
+	// tick after the last step of every recorded frame
+	std::vector<uint32_t> frame_ends;
+	size_t replay_frame = 0;
+	// steps the replay plays in total
+	uint32_t end_tick = 0;
+	uint64_t recorded_seed = 0;
+	float recorded_step_ms = 0.f;
+};
+
+extern InputQueue input_queue;
@@ -0,0 +1,141 @@
+// Header
+#include "job_system.hpp"
+
+// stlib
+#include <cassert>
+
+JobSystem job_system;
+
+namespace
+{
+	// index of the worker running on this thread, -1 on the main thread
+	thread_local int worker_index = -1;
+}
+
+void JobSystem::start(int worker_count)
+{
+	assert(!running && "JobSystem started twice");
+	if (worker_count < 0) {
+		// hardware_concurrency() may return 0 when it can't tell
+		int hardware_threads = (int)std::thread::hardware_concurrency();
+		worker_count = hardware_threads > 1 ? hardware_threads - 1 : 0;
+	}
+	running = true;
+	for (int i = 0; i < worker_count; i++)
+		queues.emplace_back(new Queue());
+	for (int i = 0; i < worker_count; i++)
+		workers.emplace_back(&JobSystem::worker_loop, this, i);
+}
+
+void JobSystem::stop()
+{
+	if (!running)
+		return;
+	{
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		running = false;
+	}
+	wake.notify_all();
+	for (std::thread& worker : workers)
+		worker.join();
+	workers.clear();
+	queues.clear();
+}
+
+void JobSystem::submit(Job job, std::atomic<int>* counter)
+{
+	// without workers everything runs on the main thread
+	if (queues.empty()) {
+		submit_main_thread(std::move(job), counter);
+		return;
+	}
+	if (counter != nullptr)
+		counter->fetch_add(1);
+	// workers keep their own jobs, the main thread spreads them round robin
+	int index = worker_index >= 0 ? worker_index : (int)(next_queue++ % queues.size());
+	{
+		std::lock_guard<std::mutex> lock(queues[index]->mutex);
+		queues[index]->jobs.emplace_back(std::move(job), counter);
+	}
+	{
+		// counted under the lock the workers sleep on, so a worker can't miss the wake up
+		std::lock_guard<std::mutex> lock(sleep_mutex);
+		queued_jobs++;
+	}
+	wake.notify_one();
+}
+
+void JobSystem::submit_main_thread(Job job, std::atomic<int>* counter)
+{
+	if (counter != nullptr)
+		counter->fetch_add(1);
+	std::lock_guard<std::mutex> lock(main_queue.mutex);
+	main_queue.jobs.emplace_back(std::move(job), counter);
+}
+
+void JobSystem::wait(std::atomic<int>& counter)
+{
+	while (counter.load() > 0) {
+		std::pair<Job, std::atomic<int>*> job;
+		if (worker_index == -1 && try_pop_front(main_queue, job)) {
+			run(job);
+			continue;
+		}
+		if (!try_run_job(worker_index))
+			std::this_thread::yield();
+	}
+}
+
+void JobSystem::worker_loop(int index)
+{
+	worker_index = index;
+	while (running) {
+		if (try_run_job(index))
+			continue;
+		std::unique_lock<std::mutex> lock(sleep_mutex);
+		wake.wait(lock, [this] { return !running || queued_jobs.load() > 0; });
+	}
+}
+
+bool JobSystem::try_run_job(int own_index)
+{
+	std::pair<Job, std::atomic<int>*> job;
+	bool found = own_index >= 0 && try_pop_back(*queues[own_index], job);
+	for (size_t i = 0; !found && i < queues.size(); i++) {
+		int victim = (int)((own_index + 1 + i) % queues.size());
+		if (victim != own_index)
+			found = try_pop_front(*queues[victim], job);
+	}
+	if (!found)
+		return false;
+	queued_jobs--;
+	run(job);
+	return true;
+}
+
+bool JobSystem::try_pop_back(Queue& queue, std::pair<Job, std::atomic<int>*>& out)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+		return false;
+	out = std::move(queue.jobs.back());
+	queue.jobs.pop_back();
+	return true;
+}
+
+bool JobSystem::try_pop_front(Queue& queue, std::pair<Job, std::atomic<int>*>& out)
+{
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.jobs.empty())
+		return false;
+	out = std::move(queue.jobs.front());
+	queue.jobs.pop_front();
+	return true;
+}
+
+void JobSystem::run(std::pair<Job, std::atomic<int>*>& job)
+{
+	job.first();
+	if (job.second != nullptr)
+		job.second->fetch_sub(1);
+}
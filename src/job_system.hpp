@@ -0,0 +1,65 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Small work-stealing thread pool.
+// Every worker owns a deque: it pops its own jobs from the back and, when that runs dry,
+// steals from the front of the others. Jobs that have to run on the main thread (anything
+// touching GL, GLFW windows or SDL) go to a separate queue that only the main thread drains,
+// which it does while it waits on a counter.
+//
+// Completion is tracked with counters: submit() increments the counter, and it is
+// decremented once the job has run. wait() helps running jobs until the counter is 0.
+class JobSystem
+{
+public:
+	using Job = std::function<void()>;
+
+	// worker_count < 0 uses one worker per hardware thread besides the main thread,
+	// 0 runs every job on the main thread
+	void start(int worker_count = -1);
+	void stop();
+
+	void submit(Job job, std::atomic<int>* counter);
+	void submit_main_thread(Job job, std::atomic<int>* counter);
+
+	// Runs other jobs until the counter is 0. Workers can wait too (a system running on a
+	// worker can split its work with parallel_for), but only the main thread runs main
+	// thread jobs while waiting.
+	void wait(std::atomic<int>& counter);
+
+	int worker_count() const { return (int)workers.size(); }
+
+private:
+	struct Queue {
+		std::mutex mutex;
+		std::deque<std::pair<Job, std::atomic<int>*>> jobs;
+	};
+
+	void worker_loop(int index);
+	// Pops from the thread's own queue or steals from another one
+	bool try_run_job(int own_index);
+	static bool try_pop_back(Queue& queue, std::pair<Job, std::atomic<int>*>& out);
+	static bool try_pop_front(Queue& queue, std::pair<Job, std::atomic<int>*>& out);
+	static void run(std::pair<Job, std::atomic<int>*>& job);
+
+	std::vector<std::unique_ptr<Queue>> queues; // one per worker
+	Queue main_queue;
+	std::vector<std::thread> workers;
+
+	std::mutex sleep_mutex;
+	std::condition_variable wake;
+	std::atomic<int> queued_jobs{ 0 };
+	std::atomic<bool> running{ false };
+	std::atomic<unsigned int> next_queue{ 0 };
+};
+
+extern JobSystem job_system;
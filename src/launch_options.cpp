@@ -0,0 +1,85 @@
+// Header
+#include "launch_options.hpp"
+
+// stlib
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+LaunchOptions launch_options;
+
+namespace
+{
+	// Returns the value of "--name=value" if arg starts with prefix, nullptr otherwise
+	const char* option_value(const char* arg, const char* prefix)
+	{
+		size_t length = strlen(prefix);
+		return strncmp(arg, prefix, length) == 0 ? arg + length : nullptr;
+	}
+}
+
+bool LaunchOptions::parse(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++) {
+		const char* arg = argv[i];
+		const char* value = nullptr;
+		if ((value = option_value(arg, "--startup-report=")) != nullptr)
+			startup_report_path = value;
+		else if ((value = option_value(arg, "--trace=")) != nullptr)
+			trace_path = value;
+		else if (strcmp(arg, "--headless") == 0)
+			headless = true;
+		else if ((value = option_value(arg, "--size=")) != nullptr) {
+			if (sscanf(value, "%dx%d", &headless_width, &headless_height) != 2 || headless_width <= 0 || headless_height <= 0) {
+				fprintf(stderr, "Invalid size %s, expected WxH\n", value);
+				return false;
+			}
+		}
+		else if ((value = option_value(arg, "--frames=")) != nullptr)
+			frames = atoi(value);
+		else if ((value = option_value(arg, "--frame-ms=")) != nullptr)
+			frame_ms = (float)atof(value);
+		else if ((value = option_value(arg, "--screenshot=")) != nullptr)
+			screenshot_path = value;
+		else if ((value = option_value(arg, "--workers=")) != nullptr)
+			workers = atoi(value);
+		else if ((value = option_value(arg, "--seed=")) != nullptr) {
+			has_seed = true;
+			seed = strtoull(value, nullptr, 10);
+		}
+		else if (strcmp(arg, "--save-json") == 0)
+			save_json = true;
+		else if (strcmp(arg, "--track-memory") == 0)
+			track_memory = true;
+		else if ((value = option_value(arg, "--memory-budget=")) != nullptr) {
+			char name[32];
+			double mb = 0.0;
+			MemoryTag tag;
+			if (sscanf(value, "%31[^:]:%lf", name, &mb) != 2 || mb < 0.0 || !memory_tag_from_name(name, tag)) {
+				fprintf(stderr, "Invalid memory budget %s, expected system:MB with a system of", value);
+				for (int t = 0; t < memory_tag_count; t++)
+					fprintf(stderr, " %s", memory_tag_name((MemoryTag)t));
+				fprintf(stderr, "\n");
+				return false;
+			}
+			memory_budgets.push_back(std::make_pair(tag, (size_t)(mb * 1024.0 * 1024.0)));
+		}
+		else if ((value = option_value(arg, "--record=")) != nullptr)
+			record_path = value;
+		else if ((value = option_value(arg, "--replay=")) != nullptr)
+			replay_path = value;
+		else {
+			fprintf(stderr, "Unknown option %s\n", arg);
+			return false;
+		}
+	}
+	if (!screenshot_path.empty() && !headless) {
+		fprintf(stderr, "--screenshot needs --headless\n");
+		return false;
+	}
+	if (!record_path.empty() && !replay_path.empty()) {
+		fprintf(stderr, "--record and --replay can't be used together\n");
+		return false;
+	}
+	return true;
+}
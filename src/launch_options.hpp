@@ -0,0 +1,64 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// internal
+#include "alloc_tracker.hpp"
+
+// Options passed on the command line, parsed once at the start of main().
+//
+// --startup-report=path  writes the startup phase timings as JSON to path
+// --trace=path           writes the last frames as a Chrome trace (chrome://tracing, Perfetto) on exit
+// --headless             renders into an offscreen framebuffer of a fixed size with a hidden window,
+//                        for benchmarks and golden image tests. Sound goes to SDL's dummy driver,
+//                        the hidden window still needs a display (Xvfb)
+// --size=WxH             headless resolution, 1500x900 by default
+// --frames=N             quits after N frames (0 = run until the game is closed)
+// --frame-ms=ms          steps the game by a fixed time per frame instead of the wall clock,
+//                        so the same number of frames always produces the same image
+// --screenshot=path      writes the last headless frame to path as a binary PPM
+// --workers=N            number of job system worker threads, one per extra core by default
+// --seed=N               master seed of the random streams (rng.hpp), a random one by default
+// --save-json            also exports every save as JSON (save_data.hpp)
+// --track-memory         counts the heap memory of every system, shown in the performance overlay
+//                        and printed on exit, in builds with LOTL_TRACK_ALLOCATIONS (alloc_tracker.hpp)
+// --memory-budget=sys:MB warns when a system holds more than MB megabytes with --track-memory,
+//                        0 for no budget; can be given once per system
+// --record=path          records the input of the session to path (see input_queue.hpp)
+// --replay=path          plays a recorded session back instead of reading the input, with its
+//                        seed and the simulation steps of every recorded frame, quits at its end
+//                        and prints the frame times
+struct LaunchOptions
+{
+	std::string startup_report_path;
+	std::string trace_path;
+
+	bool headless = false;
+	int headless_width = 1500;
+	int headless_height = 900;
+	int frames = 0;
+	float frame_ms = 0.f;
+	std::string screenshot_path;
+
+	int workers = -1;
+
+	bool has_seed = false;
+	uint64_t seed = 0;
+
+	bool save_json = false;
+
+	bool track_memory = false;
+	std::vector<std::pair<MemoryTag, size_t>> memory_budgets;
+
+	std::string record_path;
+	std::string replay_path;
+
+	// Returns false (after printing why) if an argument isn't understood
+	bool parse(int argc, char* argv[]);
+};
+
+extern LaunchOptions launch_options;
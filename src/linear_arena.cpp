@@ -0,0 +1,46 @@
+// Header
+#include "linear_arena.hpp"
+
+// stlib
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+	// enough for the UI text of the busiest screens
+	const size_t FRAME_ARENA_BYTES = 64 * 1024;
+}
+
+LinearArena frame_arena(FRAME_ARENA_BYTES);
+
+LinearArena::LinearArena(size_t capacity)
+	: block(capacity)
+{
+}
+
+void* LinearArena::allocate(size_t size, size_t align)
+{
+	uintptr_t base = (uintptr_t)block.data();
+	size_t start = (size_t)(((base + offset + align - 1) & ~(uintptr_t)(align - 1)) - base);
+	if (start + size <= block.size()) {
+		offset = start + size;
+		return block.data() + start;
+	}
+	// full, the block grows on the next reset()
+	overflow.emplace_back(new char[size + align]);
+	overflow_bytes += size + align;
+	uintptr_t memory = (uintptr_t)overflow.back().get();
+	return (void*)((memory + align - 1) & ~(uintptr_t)(align - 1));
+}
+
+void LinearArena::reset()
+{
+	peak_bytes = std::max(peak_bytes, used());
+	if (!overflow.empty()) {
+		size_t needed = offset + overflow_bytes;
+		overflow.clear();
+		block.assign(std::max(needed, block.size() * 2), 0);
+	}
+	offset = 0;
+	overflow_bytes = 0;
+}
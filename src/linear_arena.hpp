@@ -0,0 +1,42 @@
+#pragma once
+
+// stlib
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Hands out memory by bumping an offset into one block and frees all of it at once with
+// reset(), for data that lives exactly as long as a frame. Allocating is a pointer bump and
+// nothing is ever freed one by one, so nothing with a destructor that matters should be
+// put in it.
+//
+// A frame that needs more than the block gets extra blocks from the heap, and reset() then
+// grows the block to fit, so only the first frames of a new size allocate.
+class LinearArena
+{
+public:
+	explicit LinearArena(size_t capacity);
+
+	// size bytes aligned to align (a power of two), valid until reset()
+	void* allocate(size_t size, size_t align = alignof(std::max_align_t));
+	template<typename T>
+	T* allocate_array(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+	void reset();
+
+	// bytes handed out since the last reset()
+	size_t used() const { return offset + overflow_bytes; }
+	size_t capacity() const { return block.size(); }
+	// most bytes handed out between two resets
+	size_t peak() const { return peak_bytes; }
+
+private:
+	std::vector<char> block;
+	size_t offset = 0;
+	std::vector<std::unique_ptr<char[]>> overflow;
+	size_t overflow_bytes = 0;
+	size_t peak_bytes = 0;
+};
+
+// Reset by main() at the start of every frame
+extern LinearArena frame_arena;
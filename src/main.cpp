@@ -3,7 +3,10 @@
 #include <gl3w.h>
 
 // stlib
+#include <algorithm>
 #include <chrono>
+#include <random>
+#include <vector>
 
 // internal
 #include "physics_system.hpp"
@@ -12,6 +15,19 @@
 #include "world_system.hpp"
 #include "battle_system.hpp"
 #include "animation_system.hpp"
+#include "startup_profiler.hpp"
+#include "frame_profiler.hpp"
+#include "launch_options.hpp"
+#include "fixed_timestep.hpp"
+#include "job_system.hpp"
+#include "system_scheduler.hpp"
+#include "rng.hpp"
+#include "input_queue.hpp"
+#include "game_clock.hpp"
+#include "save_service.hpp"
+#include "save_journal.hpp"
+#include "linear_arena.hpp"
+#include "alloc_tracker.hpp"
 
 #include "../imgui/imgui.h"
 #include "../imgui/imgui_impl_glfw.h"
@@ -21,9 +37,53 @@
 
 using Clock = std::chrono::high_resolution_clock;
 
+// Summary of the wall clock frame times of a replay, to compare builds with
+static void print_frame_times(std::vector<float> frame_ms)
+{
+	if (frame_ms.empty())
+		return;
+	std::sort(frame_ms.begin(), frame_ms.end());
+	double total = 0.0;
+	for (float ms : frame_ms)
+		total += ms;
+	size_t count = frame_ms.size();
+	printf("Replay: %zu frames, mean %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", count, total / count,
+		frame_ms[count / 2], frame_ms[std::min(count - 1, count * 95 / 100)], frame_ms[std::min(count - 1, count * 99 / 100)], frame_ms.back());
+}
+
 // Entry point
-int main()
+int main(int argc, char* argv[])
 {
+	if (!launch_options.parse(argc, argv))
+		return EXIT_FAILURE;
+	if (launch_options.track_memory) {
+		memory_tracker.enable();
+		for (const auto& budget : launch_options.memory_budgets)
+			memory_tracker.set_budget(budget.first, budget.second);
+	}
+
+	// a replay brings its seed and the steps of every frame
+	if (!launch_options.replay_path.empty()) {
+		if (!input_queue.load_replay(launch_options.replay_path))
+			return EXIT_FAILURE;
+		if (input_queue.replay_step_ms() != FixedTimestep::STEP_MS)
+			fprintf(stderr, "The replay was recorded with %.3f ms steps, this build steps %.3f ms, it will play out differently\n",
+				input_queue.replay_step_ms(), FixedTimestep::STEP_MS);
+		launch_options.has_seed = true;
+		launch_options.seed = input_queue.replay_seed();
+		if (launch_options.frame_ms <= 0.f)
+			launch_options.frame_ms = FixedTimestep::STEP_MS;
+	}
+
+	// before any system takes its random streams
+	uint64_t seed = launch_options.seed;
+	if (!launch_options.has_seed)
+		seed = ((uint64_t)std::random_device()() << 32) | std::random_device()();
+	rng_service.seed(seed);
+	printf("Random seed %llu (--seed=%llu plays it again)\n", (unsigned long long)seed, (unsigned long long)seed);
+	if (!launch_options.record_path.empty() && !input_queue.start_recording(launch_options.record_path, seed, FixedTimestep::STEP_MS))
+		return EXIT_FAILURE;
+
 	// Global systems
 	WorldSystem world_system;
 	RenderSystem render_system;
@@ -34,37 +94,63 @@ int main()
 	GAME_STATE_ID current_game_state = GAME_STATE_ID::START_MENU;
 	
 	// Initializing window
+	startup_profiler.begin("WorldSystem::create_window");
 	GLFWwindow* window = world_system.create_window();
+	startup_profiler.end();
 	if (!window) {
-		// Time to read the error message
-		printf("Press any key to exit");
-		getchar();
+		// Time to read the error message, nobody is there to read it when headless
+		if (!launch_options.headless) {
+			printf("Press any key to exit");
+			getchar();
+		}
 		return EXIT_FAILURE;
 	}
 
 
 
 	// initialize the main systems
+	startup_profiler.begin("SoundSystem::init");
 	bool sound = sound_system.init(&current_game_state);
+	startup_profiler.end();
 	if (!sound) {
-		// Time to read the error message
-		printf("Press any key to exit");
-		getchar();
+		// Time to read the error message, nobody is there to read it when headless
+		if (!launch_options.headless) {
+			printf("Press any key to exit");
+			getchar();
+		}
 		return EXIT_FAILURE;
 	}
+	startup_profiler.begin("RenderSystem::init");
 	render_system.init(window, &current_game_state, &battle_system, &sound_system);
+	startup_profiler.end();
+	startup_profiler.begin("WorldSystem::init");
 	world_system.init(&render_system, &sound_system, &current_game_state);
+	startup_profiler.end();
 
     physics_system.lakeMesh = render_system.lakeMesh; // Add lakeMesh to physics_system
     physics_system.lakeEdges = render_system.lakeEdges; // Add lakeEdges to physics_system
 
+	startup_profiler.begin("ImGui init");
 	IMGUI_CHECKVERSION();
+	if (memory_tracker.enabled()) {
+		ImGui::SetAllocatorFunctions(
+			[](size_t size, void*) { return tracked_malloc(size, MemoryTag::IMGUI); },
+			[](void* memory, void*) { tracked_free(memory); });
+	}
 	ImGui::CreateContext();
 	ImGuiIO& io = ImGui::GetIO(); (void)io;
 	ImGui::StyleColorsDark();
-	ImGui_ImplGlfw_InitForOpenGL(window, true);
+	// recording and replaying feed ImGui the mouse of the input queue instead of the real one
+	ImGui_ImplGlfw_InitForOpenGL(window, !input_queue.feeds_imgui());
+	// without its callbacks the backend reads the real cursor every frame while the window
+	// has the focus, unless it thinks the cursor is in the window
+	if (input_queue.feeds_imgui())
+		ImGui_ImplGlfw_CursorEnterCallback(window, GLFW_TRUE);
 	ImGui_ImplOpenGL3_Init("#version 330");
+	startup_profiler.end();
+	startup_profiler.begin("RenderSystem::initFonts");
 	render_system.initFonts();
+	startup_profiler.end();
 	
 	// Set ImGui Style
 	// note: I'm dividing colours by 255.f because I'm getting RGB values from my painting software and ImVec4 colours are from 0...1
@@ -102,40 +188,157 @@ int main()
 	//style->Colors[ImGuiCol_TableRowBg] = ImVec4(0,0,0, 1.00f);
 
 	battle_system.start(&current_game_state, &sound_system);
-	// variable timestep loop
+
+	startup_profiler.finish();
+	startup_profiler.print_summary();
+	if (!launch_options.startup_report_path.empty())
+		startup_profiler.write_report(launch_options.startup_report_path);
+
+	// Systems of a simulation step, in the order they would run on a single thread.
+	// The scheduler runs the ones that don't share any pools at the same time.
+	job_system.start(launch_options.workers);
+	SystemScheduler scheduler;
+	// the states are sampled once per step, so a system changing the state doesn't
+	// change which systems run during that step
+	bool world_step = false;
+	bool battle_step = false;
+	{
+		SystemScheduler::Access access;
+		access.writes = { &registry.motions };
+		scheduler.add("store_previous_state", access, [&]() {
+			physics_system.store_previous_state();
+		});
+	}
+	scheduler.add("WorldSystem::step", SystemScheduler::exclusive_access(), [&]() {
+		if (world_step)
+			world_system.step(FixedTimestep::STEP_MS);
+	});
+	{
+		// also moves the camera (viewMatrix), which only the exclusive systems touch otherwise
+		SystemScheduler::Access access;
+		access.reads = { &registry.players, &registry.fishShadows };
+		access.writes = { &registry.motions, &registry.collisions };
+		scheduler.add("PhysicsSystem::step", access, [&]() {
+			if (world_step)
+				physics_system.step(FixedTimestep::STEP_MS);
+		});
+	}
+	{
+		// place it in world state only, i think the vertex buffers currently clash with the battle drawSpriteAnime()
+		SystemScheduler::Access access;
+		access.writes = { &registry.sprites };
+		scheduler.add("AnimationSystem::step", access, [&]() {
+			if (world_step)
+				animation_system.step(FixedTimestep::STEP_MS);
+		});
+	}
+	scheduler.add("BattleSystem::update", SystemScheduler::exclusive_access(), [&]() {
+		if (battle_step)
+			battle_system.update(FixedTimestep::STEP_MS);
+	});
+	scheduler.add("WorldSystem::handle_collisions", SystemScheduler::exclusive_access(), [&]() {
+		world_system.handle_collisions();
+	});
+
+	// fixed timestep loop
+	FixedTimestep timestep;
+	physics_system.store_previous_state();
 	auto t = Clock::now();
+	int frames_drawn = 0;
+	std::vector<float> replay_frame_ms;
 	while (!world_system.is_over()) {
+		frame_profiler.begin_frame();
+		// what the last frame put in the frame arena is gone
+		frame_arena.reset();
         if (render_system.should_restart_game) {
+            PROFILE_ZONE("restart_game");
             render_system.should_restart_game = false;
             current_game_state = GAME_STATE_ID::WORLD;
             world_system.should_load_save = true;
             world_system.restart_game();
         }
 		// Processes system messages, if this wasn't present the window would become unresponsive
-		glfwPollEvents();
+		{
+			PROFILE_ZONE("glfwPollEvents");
+			glfwPollEvents();
+		}
 
 		// Calculating elapsed times in milliseconds from the previous iteration
 		auto now = Clock::now();
 		float elapsed_ms =
 			(float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
 		t = now;
-		sound_system.update();
-		if (current_game_state == GAME_STATE_ID::WORLD) {
-			world_system.step(elapsed_ms);
-			physics_system.step(elapsed_ms);
-			// place it in world state only, i think the vertex buffers currently clash with the battle drawSpriteAnime()
-			animation_system.step(elapsed_ms);
+		if (input_queue.replaying() && frames_drawn > 0)
+			replay_frame_ms.push_back(elapsed_ms);
+		if (launch_options.frame_ms > 0.f)
+			elapsed_ms = launch_options.frame_ms;
+		{
+			PROFILE_ZONE("SoundSystem::update");
+			sound_system.update();
 		}
 
-		if (current_game_state == GAME_STATE_ID::BATTLE) {
-			battle_system.update(elapsed_ms);
+		// The simulation always advances in steps of FixedTimestep::STEP_MS, independent
+		// of the frame rate, and rendering blends between the last two steps
+		int steps = timestep.advance(elapsed_ms);
+		// the UI acts after the steps of a frame, a replay takes the steps the recording took
+		if (input_queue.replaying())
+			steps = input_queue.replay_frame_steps();
+		for (int step = 0; step < steps; step++) {
+			// time only moves with the steps, so a replay sees the times of the recording
+			game_clock.advance(FixedTimestep::STEP_MS);
+			{
+				PROFILE_ZONE("input");
+				input_queue.dispatch([&](const InputEvent& event) {
+					if (input_queue.feeds_imgui())
+						InputQueue::feed_imgui(event);
+					world_system.handle_input(event);
+				});
+			}
+			world_step = current_game_state == GAME_STATE_ID::WORLD;
+			battle_step = current_game_state == GAME_STATE_ID::BATTLE;
+			scheduler.run(job_system);
+			input_queue.next_tick();
 		}
-		//printf("%d: \n", current_game_state);
-		world_system.handle_collisions();
+		input_queue.end_frame();
+		// hand the state of the last step to the renderer
+		{
+			PROFILE_ZONE("RenderSnapshot::capture");
+			render_snapshot.capture(render_system.player);
+		}
+		// events go to the save journal every couple of seconds, and a full save starts it
+		// over once it gets long
+		if (save_journal.needs_full_save() && current_game_state == GAME_STATE_ID::WORLD)
+			render_system.autosave();
+		save_journal.poll();
+		// finished saves update the save screen
+		save_service.poll();
+		render_system.interpolation_alpha = timestep.alpha();
+		{
+			PROFILE_ZONE("RenderSystem::draw");
+			render_system.draw();
+		}
+		frame_profiler.end_frame();
+		memory_tracker.end_frame();
 
-		render_system.draw();
+		frames_drawn++;
+		if (launch_options.frames > 0 && frames_drawn >= launch_options.frames)
+			break;
+		if (input_queue.replay_finished())
+			break;
 	}
 
+	job_system.stop();
+	save_journal.flush();
+	save_service.flush();
+	input_queue.stop_recording();
+	print_frame_times(replay_frame_ms);
+	memory_tracker.print_report(stdout);
+
+	if (launch_options.headless && !launch_options.screenshot_path.empty())
+		render_system.saveScreenshot(launch_options.screenshot_path);
+	if (!launch_options.trace_path.empty())
+		frame_profiler.write_chrome_trace(launch_options.trace_path);
+
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
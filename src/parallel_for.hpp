@@ -0,0 +1,44 @@
+#pragma once
+
+// stlib
+#include <atomic>
+
+// internal
+#include "tiny_ecs.hpp"
+#include "job_system.hpp"
+
+// Calls fn(begin, end) for consecutive chunks of [0, count) on the job system and returns
+// once all of them are done. The calling thread works on the last chunk itself, and work
+// that fits into one chunk never leaves it.
+//
+// The chunks run at the same time, so fn may only write data that belongs to its own
+// range. Anything else it touches has to be read-only or synchronized.
+template <class Fn>
+void parallel_for(size_t count, size_t chunk, Fn fn)
+{
+	if (chunk == 0)
+		chunk = 1;
+	if (count <= chunk || job_system.worker_count() == 0) {
+		fn((size_t)0, count);
+		return;
+	}
+	std::atomic<int> counter{ 0 };
+	size_t begin = 0;
+	for (; begin + chunk < count; begin += chunk) {
+		size_t end = begin + chunk;
+		job_system.submit([&fn, begin, end]() { fn(begin, end); }, &counter);
+	}
+	fn(begin, count);
+	job_system.wait(counter);
+}
+
+// Calls fn(component, entity) for every component of the container, in chunks of
+// chunk components. Components must not be added or removed while it runs.
+template <typename Component, class Fn>
+void parallel_for(ComponentContainer<Component>& container, size_t chunk, Fn fn)
+{
+	parallel_for(container.components.size(), chunk, [&container, &fn](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+			fn(container.components[i], container.entities[i]);
+	});
+}
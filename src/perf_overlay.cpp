@@ -0,0 +1,192 @@
+// Header
+#include "perf_overlay.hpp"
+
+// stlib
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#ifdef __GNUG__
+#include <cxxabi.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+#include "alloc_tracker.hpp"
+#include "frame_profiler.hpp"
+#include "linear_arena.hpp"
+#include "tiny_ecs_registry.hpp"
+#include "../imgui/imgui.h"
+
+RenderStats render_stats;
+
+void RenderStats::new_frame()
+{
+	last_draw_calls = draw_calls;
+	last_texture_binds = texture_binds;
+	last_buffer_uploads = buffer_uploads;
+	last_buffer_upload_bytes = buffer_upload_bytes;
+	last_imgui_draw_calls = imgui_draw_calls;
+	last_ui_allocations = ui_allocations;
+	draw_calls = 0;
+	texture_binds = 0;
+	buffer_uploads = 0;
+	buffer_upload_bytes = 0;
+	imgui_draw_calls = 0;
+	ui_allocations = 0;
+}
+
+size_t process_resident_bytes()
+{
+#if defined(__linux__)
+	FILE* statm = fopen("/proc/self/statm", "r");
+	if (statm == nullptr)
+		return 0;
+	long pages_total = 0;
+	long pages_resident = 0;
+	int read = fscanf(statm, "%ld %ld", &pages_total, &pages_resident);
+	fclose(statm);
+	if (read != 2)
+		return 0;
+	return (size_t)pages_resident * (size_t)sysconf(_SC_PAGESIZE);
+#else
+	return 0;
+#endif
+}
+
+namespace
+{
+	// number of frames the per system timings are averaged over
+	const int AVERAGE_FRAMES = 60;
+	// how often (in frames) the memory usage is sampled, reading it is a syscall
+	const int MEMORY_SAMPLE_FRAMES = 30;
+
+	// "ComponentContainer<Motion>" -> "Motion", computed once per pool type
+	const char* pool_display_name(const char* mangled)
+	{
+		static std::unordered_map<const char*, std::string> names;
+		auto it = names.find(mangled);
+		if (it != names.end())
+			return it->second.c_str();
+
+		std::string name = mangled;
+#ifdef __GNUG__
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, &status);
+		if (status == 0 && demangled != nullptr)
+			name = demangled;
+		free(demangled);
+#endif
+		const std::string prefix = "ComponentContainer<";
+		size_t start = name.find(prefix);
+		if (start != std::string::npos && name.back() == '>')
+			name = name.substr(start + prefix.size(), name.size() - start - prefix.size() - 1);
+		return names.emplace(mangled, name).first->second.c_str();
+	}
+}
+
+void drawPerfOverlay()
+{
+	static float frame_times_ms[FrameProfiler::MAX_FRAMES];
+	static size_t resident_bytes = 0;
+	static int frames_since_memory_sample = MEMORY_SAMPLE_FRAMES;
+
+	if (++frames_since_memory_sample >= MEMORY_SAMPLE_FRAMES) {
+		resident_bytes = process_resident_bytes();
+		frames_since_memory_sample = 0;
+	}
+
+	ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.f, 0.f, 0.f, 0.75f));
+	ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.f, 1.f, 1.f, 1.f));
+	ImGui::PushStyleColor(ImGuiCol_FrameBg, ImVec4(0.2f, 0.2f, 0.2f, 1.f));
+	ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(8.f, 8.f));
+	ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 0.f);
+	ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 0.f);
+	ImGui::SetNextWindowPos(ImVec2(10.f, 10.f));
+	ImGui::Begin("Performance", NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoInputs);
+	// the game fonts are large, keep the overlay compact
+	ImGui::SetWindowFontScale(0.6f);
+
+	// Frame time graph, oldest frame on the left
+	int num_frames = frame_profiler.completed_frames();
+	float max_ms = 0.f;
+	float total_ms = 0.f;
+	for (int i = 0; i < num_frames; i++) {
+		float ms = (float)(frame_profiler.completed_frame(num_frames - 1 - i).duration_us / 1000.0);
+		frame_times_ms[i] = ms;
+		total_ms += ms;
+		if (ms > max_ms)
+			max_ms = ms;
+	}
+	float average_ms = num_frames > 0 ? total_ms / num_frames : 0.f;
+	ImGui::Text("frame %.2f ms avg (%.0f fps), %.2f ms worst", average_ms, average_ms > 0.f ? 1000.f / average_ms : 0.f, max_ms);
+	ImGui::PlotLines("##frame_times", frame_times_ms, num_frames, 0, NULL, 0.f, max_ms > 33.3f ? max_ms : 33.3f, ImVec2(500.f, 60.f));
+
+	// Per system timings of the zones in the last frame, averaged over the last frames
+	if (num_frames > 0) {
+		const FrameProfiler::Frame& last = frame_profiler.completed_frame(0);
+		int frames_to_average = num_frames < AVERAGE_FRAMES ? num_frames : AVERAGE_FRAMES;
+		for (int z = 0; z < last.zone_count; z++) {
+			const FrameProfiler::Zone& zone = last.zones[z];
+			// only the first zone of a name is listed, zone_ms() already sums repeats
+			bool seen = false;
+			for (int prev = 0; prev < z && !seen; prev++)
+				seen = strcmp(last.zones[prev].name, zone.name) == 0;
+			if (seen)
+				continue;
+			double sum_ms = 0.0;
+			double gpu_sum_ms = 0.0;
+			int gpu_frames = 0;
+			for (int f = 0; f < frames_to_average; f++) {
+				const FrameProfiler::Frame& frame = frame_profiler.completed_frame(f);
+				sum_ms += frame_profiler.zone_ms(frame, zone.name);
+				// the newest frames don't have their GPU results yet
+				double gpu_ms = frame_profiler.gpu_zone_ms(frame, zone.name);
+				if (gpu_ms >= 0.0) {
+					gpu_sum_ms += gpu_ms;
+					gpu_frames++;
+				}
+			}
+			if (gpu_frames > 0)
+				ImGui::Text("%*s%-32s %7.3f ms  gpu %7.3f ms", zone.depth * 2, "", zone.name, sum_ms / frames_to_average, gpu_sum_ms / gpu_frames);
+			else
+				ImGui::Text("%*s%-32s %7.3f ms", zone.depth * 2, "", zone.name, sum_ms / frames_to_average);
+		}
+	}
+
+	ImGui::Separator();
+	ImGui::Text("draw calls %d (+%d ImGui), texture binds %d", render_stats.last_draw_calls, render_stats.last_imgui_draw_calls, render_stats.last_texture_binds);
+	ImGui::Text("buffer uploads %d (%.1f KB)", render_stats.last_buffer_uploads, render_stats.last_buffer_upload_bytes / 1024.f);
+	if (allocations_counted())
+		ImGui::Text("UI allocations %d, frame arena %.1f/%.1f KB", render_stats.last_ui_allocations, frame_arena.peak() / 1024.f, frame_arena.capacity() / 1024.f);
+	else
+		ImGui::Text("UI allocations n/a, frame arena %.1f/%.1f KB", frame_arena.peak() / 1024.f, frame_arena.capacity() / 1024.f);
+	if (resident_bytes > 0)
+		ImGui::Text("resident memory %.1f MB", resident_bytes / (1024.f * 1024.f));
+	else
+		ImGui::Text("resident memory n/a");
+
+	// heap by system, with --track-memory
+	if (memory_tracker.enabled()) {
+		ImGui::Separator();
+		ImGui::Text("%-9s %10s %10s %10s %8s %10s", "heap", "live KB", "peak KB", "budget KB", "allocs", "alloc KB");
+		for (int t = 0; t < memory_tag_count; t++) {
+			const MemoryTagStats& stats = memory_tracker.stats((MemoryTag)t);
+			const ImVec4 colour = stats.over_budget ? ImVec4(1.f, 0.35f, 0.35f, 1.f) : ImVec4(1.f, 1.f, 1.f, 1.f);
+			ImGui::TextColored(colour, "%-9s %10.1f %10.1f %10.0f %8d %10.1f", memory_tag_name((MemoryTag)t), stats.live_bytes / 1024.f,
+				stats.peak_bytes / 1024.f, stats.budget_bytes / 1024.f, (int)stats.frame_allocations, stats.frame_bytes / 1024.f);
+		}
+	}
+
+	ImGui::Separator();
+	registry.for_each_component_count([](const char* type_name, size_t count) {
+		ImGui::Text("%6d %s", (int)count, pool_display_name(type_name));
+	});
+
+	ImGui::End();
+	ImGui::PopStyleVar(3);
+	ImGui::PopStyleColor(3);
+}
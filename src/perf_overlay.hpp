@@ -0,0 +1,37 @@
+#pragma once
+
+// stlib
+#include <cstddef>
+
+// GL work counted by the RenderSystem every frame, shown in the performance overlay.
+// Incrementing these is all the bookkeeping the overlay costs while hidden.
+struct RenderStats
+{
+	int draw_calls = 0;
+	int texture_binds = 0;
+	int buffer_uploads = 0;
+	size_t buffer_upload_bytes = 0;
+	int imgui_draw_calls = 0; // one per ImDrawCmd, each also binds a texture
+	// heap allocations from ImGui::NewFrame() to ImGui::Render(), 0 once the UI is warm. Only
+	// counted in builds with LOTL_TRACK_ALLOCATIONS (alloc_tracker.hpp).
+	int ui_allocations = 0;
+
+	// Values of the last complete frame, the overlay is drawn before the current one ends
+	int last_draw_calls = 0;
+	int last_texture_binds = 0;
+	int last_buffer_uploads = 0;
+	size_t last_buffer_upload_bytes = 0;
+	int last_imgui_draw_calls = 0;
+	int last_ui_allocations = 0;
+
+	// Moves the current counters to last_* and starts counting from zero
+	void new_frame();
+};
+extern RenderStats render_stats;
+
+// Resident memory of the process in bytes, 0 if unknown on this platform
+size_t process_resident_bytes();
+
+// Draws the performance overlay (frame time graph, per system timings, GL counters,
+// ECS pool sizes and memory). Must be called inside an ImGui frame.
+void drawPerfOverlay();
@@ -1,9 +1,14 @@
 // internal
 #include "physics_system.hpp"
 #include "world_system.hpp"
+#include "parallel_for.hpp"
 #include <iostream>
 
 Transform viewMatrix; // For camera
+Transform previousViewMatrix; // Camera at the end of the previous simulation step
+
+// Motions moved per job, the boundary check of the player makes some chunks heavier
+const size_t MOTION_CHUNK = 256;
 
 // Checks if two vectors are intersecting (for player-lake boundary detection).
 // Used tutorial from: https://stackoverflow.com/questions/217578/how-can-i-determine-whether-a-2d-point-is-within-a-polygon
@@ -80,16 +85,25 @@ bool collides(const Motion& motion1, const Motion& motion2)
 	// return false;
 }
 
+void PhysicsSystem::store_previous_state()
+{
+	for (Motion& motion : registry.motions.components) {
+		motion.previous_position = motion.position;
+		motion.has_previous_position = true;
+	}
+	previousViewMatrix = viewMatrix;
+}
+
 void PhysicsSystem::step(float elapsed_ms)
 {
 	// Move fish based on how much time has passed, this is to (partially) avoid
 	// having entities move at different speed based on the machine.
+	// Motions are independent of each other, so they are moved in parallel. Only the player
+	// moves the camera and nothing in here adds or removes components.
 	auto& motion_container = registry.motions;
-	for(uint i = 0; i < motion_container.size(); i++)
+	parallel_for(motion_container, MOTION_CHUNK, [&](Motion& motion, Entity entity)
 	{
 		// update motion.position based on step_seconds and motion.velocity
-		Motion& motion = motion_container.components[i];
-		Entity entity = motion_container.entities[i];
 		float step_seconds = elapsed_ms / 1000.f;
         //fprintf(stderr, "elapsed ms: %f, step seconds: %f \n", elapsed_ms, step_seconds);
 
@@ -174,7 +188,7 @@ void PhysicsSystem::step(float elapsed_ms)
 
         }
 
-	}
+	});
 	// Check for collisions between all moving entities
 	for(uint i = 0; i < motion_container.components.size(); i++)
 	{
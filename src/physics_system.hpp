@@ -12,6 +12,9 @@ public:
     std::vector<TexturedVertex> lakeMesh; // For defining lake boundary
     std::vector<vec2> lakeEdges; // For defining lake edges
 	void step(float elapsed_ms);
+	// Remembers the motions and camera before a simulation step so rendering can
+	// interpolate between steps
+	void store_previous_state();
 
 	PhysicsSystem()
 	{
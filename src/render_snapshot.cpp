@@ -0,0 +1,69 @@
+// Header
+#include "render_snapshot.hpp"
+
+#include "tiny_ecs_registry.hpp"
+
+RenderSnapshot render_snapshot;
+
+extern Transform viewMatrix;
+extern Transform previousViewMatrix;
+
+namespace
+{
+	bool is_player_sheet(TEXTURE_ASSET_ID texture)
+	{
+		return texture == TEXTURE_ASSET_ID::PLAYER_LEFT_SHEET || texture == TEXTURE_ASSET_ID::PLAYER_RIGHT_SHEET ||
+			texture == TEXTURE_ASSET_ID::PLAYER_UP_SHEET || texture == TEXTURE_ASSET_ID::PLAYER_DOWN_SHEET;
+	}
+}
+
+void RenderSnapshot::capture(Entity player)
+{
+	// items keeps its capacity, so this only allocates when the world grows
+	items.clear();
+	view = viewMatrix;
+	previous_view = previousViewMatrix;
+
+	bool player_lit = registry.lightUp.has(player);
+	float catching_bar_filled = 0.f;
+	if (registry.catchingBars.size() > 0)
+		catching_bar_filled = registry.catchingBars.components[0].filled;
+
+	// players go last, the rest keeps the order of renderRequests
+	for (int pass = 0; pass < 2; pass++) {
+		auto& render_requests = registry.renderRequests;
+		for (size_t i = 0; i < render_requests.entities.size(); i++) {
+			Entity entity = render_requests.entities[i];
+			bool is_player = registry.players.has(entity);
+			if (is_player != (pass == 1) || !registry.motions.has(entity))
+				continue;
+			const RenderRequest& render_request = render_requests.components[i];
+			const Motion& motion = registry.motions.get(entity);
+
+			Item item;
+			item.previous_position = motion.previous_position;
+			item.position = motion.position;
+			item.has_previous_position = motion.has_previous_position;
+			item.scale = motion.scale;
+			item.texture = render_request.used_texture;
+			if (registry.sprites.has(entity)) {
+				const Sprite& sprite = registry.sprites.get(entity);
+				item.is_sprite = true;
+				item.frame = sprite.current_frame;
+				item.rows = sprite.rows;
+				item.columns = sprite.columns;
+				item.light_up = player_lit && is_player_sheet(render_request.used_texture);
+			}
+			else {
+				if (!render_request.is_visible)
+					continue;
+				item.effect = render_request.used_effect;
+				item.geometry = render_request.used_geometry;
+				item.fish_texture = render_request.fish_texture;
+				item.color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
+				item.catching_bar_filled = catching_bar_filled;
+			}
+			items.push_back(item);
+		}
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+// stlib
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "components.hpp"
+#include "tiny_ecs.hpp"
+
+// Everything the world pass of RenderSystem::draw() needs from the registry, copied out
+// once the simulation steps of a frame are done. The world pass draws from a snapshot
+// only, so it never looks at (or sorts) the live registry.
+struct RenderSnapshot
+{
+	struct Item {
+		// sprite sheet frame (drawSpriteAnime) or a whole mesh (drawTexturedMesh)
+		bool is_sprite = false;
+
+		vec2 previous_position = { 0.f, 0.f };
+		vec2 position = { 0.f, 0.f };
+		bool has_previous_position = false;
+		vec2 scale = { 1.f, 1.f };
+		TEXTURE_ASSET_ID texture = TEXTURE_ASSET_ID::TEXTURE_COUNT;
+
+		// sprites
+		int frame = 0;
+		int rows = 1;
+		int columns = 1;
+		bool light_up = false;
+
+		// meshes
+		EFFECT_ASSET_ID effect = EFFECT_ASSET_ID::EFFECT_COUNT;
+		GEOMETRY_BUFFER_ID geometry = GEOMETRY_BUFFER_ID::GEOMETRY_COUNT;
+		FISH_TEXTURE_ASSET_ID fish_texture = FISH_TEXTURE_ASSET_ID::FISH_TEXTURE_COUNT;
+		vec3 color = vec3(1.f);
+		float catching_bar_filled = 0.f;
+
+		vec2 interpolated_position(float alpha) const
+		{
+			return has_previous_position ? previous_position + (position - previous_position) * alpha : position;
+		}
+	};
+
+	// in draw order, the player is drawn last so it is on top
+	std::vector<Item> items;
+	Transform view;
+	Transform previous_view;
+
+	// Copies the visible entities and the camera out of the registry
+	void capture(Entity player);
+};
+
+// The snapshot of the last simulation step. main() captures it after the steps of a frame and
+// the world pass draws it, one after the other on the main thread: there is no render thread,
+// so simulation and rendering don't overlap. drawToScreen() and the ImGui panels still read
+// the registry directly.
+extern RenderSnapshot render_snapshot;
@@ -5,9 +5,24 @@
 #include <map>
 #include <glm/gtc/matrix_transform.hpp>
 #include <random>
+#include <ctime>
+#include <cstring>
 
 #include "tiny_ecs_registry.hpp"
 #include "world_init.hpp"
+#include "frame_profiler.hpp"
+#include "perf_overlay.hpp"
+#include "gpu_profiler.hpp"
+#include "launch_options.hpp"
+#include "render_snapshot.hpp"
+#include "game_clock.hpp"
+#include "save_data.hpp"
+#include "save_service.hpp"
+#include "save_journal.hpp"
+#include "fish_collection.hpp"
+#include "ui_text.hpp"
+#include "linear_arena.hpp"
+#include "alloc_tracker.hpp"
 #include "../imgui/imgui.h"
 #include "../imgui/imgui_impl_glfw.h"
 #include "../imgui/imgui_impl_opengl3.h"
@@ -17,6 +32,7 @@ extern bool second_lake_unlocked;
 extern Entity bgEntity;
 
 extern Transform viewMatrix;
+extern Transform previousViewMatrix;
 bool show_inventory = true;
 bool show_fishing_log = false;
 bool inventory_button_active = true;
@@ -42,7 +58,8 @@ float hpFill = 0.0f;
 float hpFillEnemy = 0.0f;
 char hpText[32];
 char hpTextEnemy[32];
-std::string battleLogText;
+// kept across frames, some battle states show the line of the one before
+char battleLogText[128];
 int battle_tutorial_index = 0;
 
 bool partyMemberOneAdded = false;
@@ -61,33 +78,42 @@ enum class SHOP_STATE
 SHOP_STATE shop_state = SHOP_STATE::WELCOME;
 
 // https://stackoverflow.com/questions/64653747/how-to-center-align-text-horizontally
-void textCentered(std::string text) {
+void textCentered(const char* text) {
     auto windowWidth = ImGui::GetWindowSize().x;
-    auto textWidth = ImGui::CalcTextSize(text.c_str()).x;
+    auto textWidth = ImGui::CalcTextSize(text).x;
     ImGui::SetCursorPosX(10.f);
     if (textWidth < windowWidth) {
         ImGui::SetCursorPosX((windowWidth - textWidth) * 0.5f);
     }
 
-    ImGui::TextWrapped(text.c_str());
+    ImGui::TextWrapped("%s", text);
 }
 
-void RenderSystem::drawTexturedMesh(Entity entity,
+// The dialogue json is read every frame, these point into it instead of copying
+const json& jsonChild(const json& object, const char* key) {
+    static const json none;
+    auto it = object.find(key);
+    return it != object.end() ? *it : none;
+}
+
+const char* jsonText(const json& object, const char* key, const char* fallback) {
+    auto it = object.find(key);
+    if (it == object.end() || !it->is_string())
+        return fallback;
+    return it->get_ref<const std::string&>().c_str();
+}
+
+void RenderSystem::drawTexturedMesh(const RenderSnapshot::Item &item,
                                     const mat3 &projection)
 {
-    Motion &motion = registry.motions.get(entity);
     // Transformation code, see Rendering and Transformation in the template
     // specification for more info Incrementally updates transformation matrix,
     // thus ORDER IS IMPORTANT
     Transform transform;
-    transform.translate(motion.position);
-    transform.scale(motion.scale);
+    transform.translate(item.interpolated_position(interpolation_alpha));
+    transform.scale(item.scale);
 
-
-    assert(registry.renderRequests.has(entity));
-    const RenderRequest &render_request = registry.renderRequests.get(entity);
-
-    const GLuint used_effect_enum = (GLuint)render_request.used_effect;
+    const GLuint used_effect_enum = (GLuint)item.effect;
     assert(used_effect_enum != (GLuint)EFFECT_ASSET_ID::EFFECT_COUNT);
     const GLuint program = (GLuint)effects[used_effect_enum];
 
@@ -95,9 +121,9 @@ void RenderSystem::drawTexturedMesh(Entity entity,
     glUseProgram(program);
     gl_has_errors();
 
-    assert(render_request.used_geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT);
-    const GLuint vbo = vertex_buffers[(GLuint)render_request.used_geometry];
-    const GLuint ibo = index_buffers[(GLuint)render_request.used_geometry];
+    assert(item.geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT);
+    const GLuint vbo = vertex_buffers[(GLuint)item.geometry];
+    const GLuint ibo = index_buffers[(GLuint)item.geometry];
 
     // Setting vertex and index buffers
     glBindBuffer(GL_ARRAY_BUFFER, vbo);
@@ -105,7 +131,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
     gl_has_errors();
 
     // Input data location as in the vertex buffer
-    if (render_request.used_effect == EFFECT_ASSET_ID::TEXTURED)
+    if (item.effect == EFFECT_ASSET_ID::TEXTURED)
     {
         GLint in_position_loc = glGetAttribLocation(program, "in_position");
         GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
@@ -127,22 +153,21 @@ void RenderSystem::drawTexturedMesh(Entity entity,
         glActiveTexture(GL_TEXTURE0);
         gl_has_errors();
 
-        assert(registry.renderRequests.has(entity));
-
         GLuint texture_id;
-        if (render_request.fish_texture != FISH_TEXTURE_ASSET_ID::FISH_TEXTURE_COUNT) {
+        if (item.fish_texture != FISH_TEXTURE_ASSET_ID::FISH_TEXTURE_COUNT) {
             texture_id =
-                fish_texture_gl_handles[(GLuint)registry.renderRequests.get(entity).fish_texture];
+                fish_texture_gl_handles[(GLuint)item.fish_texture];
         }
         else {
             texture_id =
-                texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+                texture_gl_handles[(GLuint)item.texture];
         }
 
         glBindTexture(GL_TEXTURE_2D, texture_id);
+        render_stats.texture_binds++;
         gl_has_errors();
     }
-    else if (render_request.used_effect == EFFECT_ASSET_ID::PLAYER)
+    else if (item.effect == EFFECT_ASSET_ID::PLAYER)
     {
         GLint in_position_loc = glGetAttribLocation(program, "in_position");
         GLint in_color_loc = glGetAttribLocation(program, "in_color");
@@ -158,7 +183,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
                               sizeof(ColoredVertex), (void *)sizeof(vec3));
         gl_has_errors();
     }
-    else if (render_request.used_effect == EFFECT_ASSET_ID::CATCHING_BAR)
+    else if (item.effect == EFFECT_ASSET_ID::CATCHING_BAR)
     {
       GLint in_position_loc = glGetAttribLocation(program, "in_position");
       GLint in_texcoord_loc = glGetAttribLocation(program, "in_texcoord");
@@ -180,16 +205,15 @@ void RenderSystem::drawTexturedMesh(Entity entity,
       glActiveTexture(GL_TEXTURE0);
       gl_has_errors();
 
-      assert(registry.renderRequests.has(entity));
       GLuint texture_id =
-        texture_gl_handles[(GLuint)registry.renderRequests.get(entity).used_texture];
+        texture_gl_handles[(GLuint)item.texture];
 
       glBindTexture(GL_TEXTURE_2D, texture_id);
+      render_stats.texture_binds++;
       gl_has_errors();
 
       GLint uFilled_uloc = glGetUniformLocation(program, "uFilled");
-      const float filled = registry.catchingBars.get(registry.catchingBars.entities[0]).filled;
-      glUniform1f(uFilled_uloc, (float) filled);
+      glUniform1f(uFilled_uloc, item.catching_bar_filled);
       gl_has_errors();
     }
     else
@@ -198,8 +222,7 @@ void RenderSystem::drawTexturedMesh(Entity entity,
     }
     // Getting uniform locations for glUniform* calls
     GLint color_uloc = glGetUniformLocation(program, "fcolor");
-    const vec3 color = registry.colors.has(entity) ? registry.colors.get(entity) : vec3(1);
-    glUniform3fv(color_uloc, 1, (float *)&color);
+    glUniform3fv(color_uloc, 1, (float *)&item.color);
     gl_has_errors();
 
     // Get number of indices from index buffer, which has elements uint16_t
@@ -220,26 +243,45 @@ void RenderSystem::drawTexturedMesh(Entity entity,
 
     // glm::mat3 viewMatrix = glm::mat3(1.0f);
     GLuint view_loc = glGetUniformLocation(currProgram, "view");
-    glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float *)&viewMatrix);
+    glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float *)&interpolated_view);
     gl_has_errors();
     // Drawing of num_indices/3 triangles specified in the index buffer
     glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr);
+    render_stats.draw_calls++;
     gl_has_errors();
 }
 
 
 
+// Finishes the ImGui frame and submits its draw lists
+void RenderSystem::renderImGui()
+{
+    PROFILE_ZONE("ImGui render");
+    if (debugging.show_perf_overlay)
+        drawPerfOverlay();
+    GPU_PROFILE_ZONE("ImGui render");
+    ImGui::Render();
+    render_stats.ui_allocations += (int)(thread_allocations() - ui_allocations_at_new_frame);
+    ImDrawData* draw_data = ImGui::GetDrawData();
+    for (int i = 0; i < draw_data->CmdListsCount; i++)
+        render_stats.imgui_draw_calls += draw_data->CmdLists[i]->CmdBuffer.Size;
+    ImGui_ImplOpenGL3_RenderDrawData(draw_data);
+}
+
 // draw the intermediate texture to the screen
 void RenderSystem::drawToScreen()
 {
+    PROFILE_ZONE("drawToScreen");
+    frame_profiler.begin_zone("water composite");
+    gpu_profiler.begin_zone("water composite");
     // Setting shaders
     // get the water texture, sprite mesh, and program - the "water" is our world screen
     glUseProgram(effects[(GLuint)EFFECT_ASSET_ID::WATER]);
     gl_has_errors();
     // Clearing backbuffer
     int w, h;
-    glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    getDrawableSize(w, h);
+    glBindFramebuffer(GL_FRAMEBUFFER, present_frame_buffer);
 
     glViewport(0, 0, w, h);
 
@@ -248,6 +290,7 @@ void RenderSystem::drawToScreen()
     glClearDepth(1.f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
+    ui_allocations_at_new_frame = thread_allocations();
     ImGui_ImplOpenGL3_NewFrame();
     ImGui_ImplGlfw_NewFrame();
     ImGui::NewFrame();
@@ -289,13 +332,17 @@ void RenderSystem::drawToScreen()
     glActiveTexture(GL_TEXTURE0);
 
     glBindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
+    render_stats.texture_binds++;
     gl_has_errors();
     // Draw
     glDrawElements(
             GL_TRIANGLES, 3, GL_UNSIGNED_SHORT,
             nullptr); // one triangle = 3 vertices; nullptr indicates that there is
     // no offset from the bound index buffer
+    render_stats.draw_calls++;
     gl_has_errors();
+    gpu_profiler.end_zone();
+    frame_profiler.end_zone();
 
     //reset the popup
     if (*current_game_state != GAME_STATE_ID::PARTY && show_party_list == true) {
@@ -306,30 +353,31 @@ void RenderSystem::drawToScreen()
         shop_state = SHOP_STATE::WELCOME;
     }
 
+    if (*current_game_state != GAME_STATE_ID::SAVE_DONE && save_status == SaveStatus::DONE) {
+        save_status = SaveStatus::IDLE;
+    }
+
     // This is the UI that always appears in the World View and the Menu View. It should not appear during Battle View though.
     float step = 35.f;
     switch (*current_game_state)
     {
         case GAME_STATE_ID::START_MENU: {
             drawStartMenu();
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-            std::random_device rd;
-            std::mt19937 gen(rd());
+            renderImGui();
             std::uniform_real_distribution<float> xDistribution(-20.0f, 20.0f);
             std::uniform_real_distribution<float> yDistribution(-10.0f, 10.0f);
             int index = 0;
             float offset = 0.1f;
-            if (glfwGetTime() - lastTime > 0.5f) {
+            if (game_clock.now() - lastTime > 0.5f) {
                 for (int y = 0; y < 10; ++y) {
                     for (int x = 0; x < 10; ++x) {
                         glm::vec2 translation;
-                        translation.x = xDistribution(gen) * 0.05f;
-                        translation.y = yDistribution(gen) * 0.05f - 1.f;
+                        translation.x = xDistribution(menu_rng) * 0.05f;
+                        translation.y = yDistribution(menu_rng) * 0.05f - 1.f;
                         translations[index++] = translation;
                     }
                 }
-                lastTime = glfwGetTime();
+                lastTime = game_clock.now();
             }
             
             mat3 projection_2D = createProjectionMatrix();
@@ -405,6 +453,7 @@ void RenderSystem::drawToScreen()
             // rod idle depends on screen, not camera position
             glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&viewScreenMatrix);
             glDrawArraysInstanced(GL_TRIANGLES, 0, 6, 100);
+            render_stats.draw_calls++;
             gl_has_errors();
             break;
         }
@@ -446,7 +495,7 @@ void RenderSystem::drawToScreen()
                 }
 
                 setDrawCursorScreenPos(ImVec2(0.f, 20.f));
-                textCentered(popup.value("text", "error"));
+                textCentered(jsonText(popup, "text", "error"));
 
                 setDrawCursorScreenPos(ImVec2(0.f, 10.f));
                 ImGui::SetCursorPosX((window_size.x - 120.f) * 0.5f);
@@ -459,23 +508,19 @@ void RenderSystem::drawToScreen()
             }
             ImGui::PopStyleVar(2);
 
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			renderImGui();
             break;
         case GAME_STATE_ID::INVENTORY:
             drawInventory();
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			renderImGui();
             break;
         case GAME_STATE_ID::SHOP:
             drawShop();
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			renderImGui();
             break;
         case GAME_STATE_ID::PARTY:
             drawParty();
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+			renderImGui();
             break;
         case GAME_STATE_ID::SETTINGS:
             drawSettingsMain("Settings", TEXTURE_ASSET_ID::SETTINGS);
@@ -485,8 +530,7 @@ void RenderSystem::drawToScreen()
             createSettingsButtonWindow("Load button","##LoadButton", ImVec2(280.0f * scale_x, 365.0f * scale_y), GAME_STATE_ID::LOAD);
             createSettingsButtonWindow("Tutorial button","##TutorialButton", ImVec2(280.0f * scale_x, 500.0f * scale_y), GAME_STATE_ID::TUTORIAL);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::TELEPORT_1:
             drawSettingsMain("Teleport 1", TEXTURE_ASSET_ID::TELEPORT_1);
@@ -495,39 +539,42 @@ void RenderSystem::drawToScreen()
             createSaveButtons("Tel1 Yes", "##Tel1Button1", ImVec2(412.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::TELEPORT_1_DONE);
             createSaveButtons("Tel1 No","##Tel1Button2", ImVec2(815.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::WORLD);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::TELEPORT_1_DONE: {
             currently_lake_1 = true;
             LakeId& lakeInfo = registry.lakes.get(player);
             lakeInfo.id = 1;
+            save_journal.record(JournalRecord::lake_changed(1));
             RenderRequest& rr = registry.renderRequests.get(bgEntity);
             rr.used_texture = TEXTURE_ASSET_ID::BACKGROUND;
             Motion& motion = registry.motions.get(player);
             motion.position.x = (float) window_width_px / 2.f;
             motion.position.y = (float) window_height_px / 2.f;
+            motion.has_previous_position = false;
             viewMatrix.mat[2][0] = 0.f;
             viewMatrix.mat[2][1] = 0.f;
+            previousViewMatrix = viewMatrix;
             *current_game_state = GAME_STATE_ID::WORLD;
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         }
         case GAME_STATE_ID::TELEPORT_2_DONE: {
             currently_lake_1 = false;
             LakeId& lakeInfo = registry.lakes.get(player);
             lakeInfo.id = 2;
+            save_journal.record(JournalRecord::lake_changed(2));
             RenderRequest& rr = registry.renderRequests.get(bgEntity);
             rr.used_texture = TEXTURE_ASSET_ID::BACKGROUND_2;
             Motion& motion = registry.motions.get(player);
             motion.position.x = (float) window_width_px / 2.f;
             motion.position.y = (float) window_height_px / 2.f;
+            motion.has_previous_position = false;
             viewMatrix.mat[2][0] = 0.f;
             viewMatrix.mat[2][1] = 0.f;
+            previousViewMatrix = viewMatrix;
             *current_game_state = GAME_STATE_ID::WORLD;
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         }
         case GAME_STATE_ID::TELEPORT_2:
@@ -537,39 +584,36 @@ void RenderSystem::drawToScreen()
             createSaveButtons("Tel2 Yes", "##Tel2Button1", ImVec2(412.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::TELEPORT_2_DONE);
             createSaveButtons("Tel2 No","##Tel2Button2", ImVec2(815.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::WORLD);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::SAVE:
             drawSettingsMain("Save", TEXTURE_ASSET_ID::SAVE);
+            drawSaveSlots(false);
 
             // Draw buttons over save options
             createSaveButtons("Save Yes", "##SaveButton1", ImVec2(412.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::SAVE_DONE);
             createSaveButtons("Save No","##SaveButton2", ImVec2(815.0f * scale_x, 495.0f * scale_y), GAME_STATE_ID::SETTINGS);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::LOAD:
             drawSettingsMain("Load", TEXTURE_ASSET_ID::LOAD);
+            drawSaveSlots(true);
 
             // Draw buttons over load options
             createSaveButtons("Load Yes", "##LoadButton1", ImVec2(370.0f * scale_x, 525.0f * scale_y), GAME_STATE_ID::LOAD_SAVE);
             createSaveButtons("Load No","##LoadButton2", ImVec2(865.0f * scale_x, 525.0f * scale_y), GAME_STATE_ID::SETTINGS);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::LOAD_SAVE: {
-            std::ifstream is("../savedata.json", std::ios::ate);
-            if (is.tellg() == 0) { // check if save data exists
+            if (!save_slots.used(save_slots.selected())) {
                 *current_game_state = GAME_STATE_ID::LOAD_FAIL;
             } else {
                 should_restart_game = true;
             }
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         }
         case GAME_STATE_ID::LOAD_FAIL:
@@ -578,40 +622,44 @@ void RenderSystem::drawToScreen()
             createSaveButtons("Load Fail Button", "##LoadFailButton", ImVec2(620.0f * scale_x, 500.0f * scale_y),
                               GAME_STATE_ID::WORLD);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::SAVE_DONE: {
-            saveData();
+            if (save_status == SaveStatus::IDLE) {
+                saveData();
+            }
 
-            drawSettingsMain("Save Done", TEXTURE_ASSET_ID::SAVE_DONE);
+            // the save is written in the background, it's only done once it's on the disk
+            if (save_status == SaveStatus::SAVING) {
+                drawSettingsMain("Save", TEXTURE_ASSET_ID::SAVE);
+            } else {
+                drawSettingsMain("Save Done", TEXTURE_ASSET_ID::SAVE_DONE);
 
-            createSaveButtons("Save Complete", "##SaveDoneButton", ImVec2(620.0f * scale_x, 500.0f * scale_y),
-                              GAME_STATE_ID::WORLD);
+                createSaveButtons("Save Complete", "##SaveDoneButton", ImVec2(620.0f * scale_x, 500.0f * scale_y),
+                                  GAME_STATE_ID::WORLD);
+            }
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         }
         case GAME_STATE_ID::DELETE_SAVE:
             drawSettingsMain("Delete Save", TEXTURE_ASSET_ID::DELETE_SAVE);
+            drawSaveSlots(true);
 
             // Draw buttons over load options
             createSaveButtons("Delete Yes", "##DelButton1", ImVec2(370.0f * scale_x, 525.0f * scale_y), GAME_STATE_ID::DELETE_SAVE_DONE);
             createSaveButtons("Delete No","##DelButton2", ImVec2(865.0f * scale_x, 525.0f * scale_y), GAME_STATE_ID::WORLD);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::DELETE_SAVE_DONE: {
-            std::ofstream os("../savedata.json", std::ios::trunc);
+            // the save was deleted by the "Delete Yes" button, see createSaveButtons()
             drawSettingsMain("Delete Done", TEXTURE_ASSET_ID::DELETE_SAVE_DONE);
 
             createSaveButtons("Delete Complete", "##DelDoneButton", ImVec2(620.0f * scale_x, 500.0f * scale_y),
                               GAME_STATE_ID::WORLD);
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         }
         case GAME_STATE_ID::TUTORIAL:
@@ -624,25 +672,21 @@ void RenderSystem::drawToScreen()
 
             createTutorialBackButton("Back Button", "##BackButton",ImVec2(0, 0), GAME_STATE_ID::SETTINGS);
 
-            ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::TUTORIAL_BASIC:
             drawTutorialScreen("Basic Tutorial", 23);
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             registry.players.get(player).basic_tutorial_complete = true;
             break;
         case GAME_STATE_ID::TUTORIAL_FISH:
             drawTutorialScreen("Fishing Tutorial", 24);
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             registry.players.get(player).fishing_tutorial_complete = true;
             break;
         case GAME_STATE_ID::TUTORIAL_BATTLE:
             drawTutorialScreen("Battle Tutorial", 25);
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
         case GAME_STATE_ID::CUTSCENE:
             // this may need refactoring into its own system since ideally we would pass cutscene id from the event that triggers cutscene...? or pass id through global variable lol. since only one cutscene can play at a time
@@ -651,8 +695,7 @@ void RenderSystem::drawToScreen()
             if (!registry.dialogues.components.empty()) {
                 drawDialogueCutscene();
             }
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
 
             break;
 		case GAME_STATE_ID::BATTLE:
@@ -664,63 +707,65 @@ void RenderSystem::drawToScreen()
                 snprintf(hpTextEnemy, sizeof(hpTextEnemy), "%.0f/%.0f", battle_system->enemySpecies.health, battle_system->enemyMaxHealth);
             }
 			drawBattle();
-			ImGui::Render();
-			ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
-            // fishing rod sprite animes
-            drawPlayerAnime();
-            // party member portraits
-            for (int i = 0; i < battle_system->allMembers.size(); i++) {
-                std::vector<Entity> members = registry.partyMembers.entities;
-                PartyMember p = registry.partyMembers.get(members[i]);
-                float xpos = 361.f + i * 300.f;
-                drawPortraitsAnime(xpos, p.texture_id);
-                if (p.name == battle_system->allMembers[battle_system->currMemberIndex].name && battle_system->curr_battle_state != BattleSystem::StateEnum::STATE_ROUND_BEGIN) {
-                    float time = (float)glfwGetTime();
-                    float oscillationValue = 0.02f * std::sin(M_PI * time) + .99f;
-                    drawSpriteEffect(TEXTURE_ASSET_ID::ARROW, EFFECT_ASSET_ID::EFFECT, vec4(1), { xpos, window_height_px / 2.f * oscillationValue}, { 100.f, 100.f });
+			renderImGui();
+            {
+                PROFILE_ZONE("battle overlays");
+                GPU_PROFILE_ZONE("battle overlays");
+                // fishing rod sprite animes
+                drawPlayerAnime();
+                // party member portraits
+                for (int i = 0; i < battle_system->allMembers.size(); i++) {
+                    std::vector<Entity> members = registry.partyMembers.entities;
+                    PartyMember p = registry.partyMembers.get(members[i]);
+                    float xpos = 361.f + i * 300.f;
+                    drawPortraitsAnime(xpos, p.texture_id);
+                    if (p.name == battle_system->allMembers[battle_system->currMemberIndex].name && battle_system->curr_battle_state != BattleSystem::StateEnum::STATE_ROUND_BEGIN) {
+                        float time = (float)game_clock.now();
+                        float oscillationValue = 0.02f * std::sin(M_PI * time) + .99f;
+                        drawSpriteEffect(TEXTURE_ASSET_ID::ARROW, EFFECT_ASSET_ID::EFFECT, vec4(1), { xpos, window_height_px / 2.f * oscillationValue}, { 100.f, 100.f });
+                    }
                 }
-            }
-            // overlaying particle effects
-            if (battle_system->curr_battle_state == BattleSystem::STATE_PLAYER_ACTING) {
-                if (battle_system->selectedAnime == BattleSystem::ALLY_MANIFEST) {
-                    drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, ally1_purple, { window_width_px / 2, 280.f}, vec2(100.f + 10.f * sin(4.f * (float)glfwGetTime())));
-                    drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, vec4(1), { window_width_px / 2, 280.f}, vec2(75.f + 10.f * sin(4.f * (float)glfwGetTime())));
-                    battle_system->createParticles(BattleSystem::ALLY_MANIFEST);
+                // overlaying particle effects
+                if (battle_system->curr_battle_state == BattleSystem::STATE_PLAYER_ACTING) {
+                    if (battle_system->selectedAnime == BattleSystem::ALLY_MANIFEST) {
+                        drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, ally1_purple, { window_width_px / 2, 280.f}, vec2(100.f + 10.f * sin(4.f * (float)game_clock.now())));
+                        drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, vec4(1), { window_width_px / 2, 280.f}, vec2(75.f + 10.f * sin(4.f * (float)game_clock.now())));
+                        battle_system->createParticles(BattleSystem::ALLY_MANIFEST);
+                    }
                 }
-            }
-            for (Particle const& particle : battle_system->particles)
-            {
-                if (particle.life > 0.0f)
+                for (Particle const& particle : battle_system->particles)
                 {
-                    drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, particle.color, particle.position, particle.size);
-                    //drawMeshEffect(GEOMETRY_BUFFER_ID::PEBBLE, EFFECT_ASSET_ID::PARTICLE, particle.color, { window_width_px / 2 + particle.position.x, window_height_px / 2 + particle.position.y }, 0, particle.size);
+                    if (particle.life > 0.0f)
+                    {
+                        drawSpriteEffect(TEXTURE_ASSET_ID::PARTICLE, EFFECT_ASSET_ID::EFFECT, particle.color, particle.position, particle.size);
+                        //drawMeshEffect(GEOMETRY_BUFFER_ID::PEBBLE, EFFECT_ASSET_ID::PARTICLE, particle.color, { window_width_px / 2 + particle.position.x, window_height_px / 2 + particle.position.y }, 0, particle.size);
+                    }
                 }
-            }
-            if (battle_system->curr_battle_state == BattleSystem::STATE_EFFECT_PLAYING) {
-                playEffect(battle_system->selectedAnime);
-                if (battle_system->selectedAnime == BattleSystem::ALLY_DOOM && buffIndex == 1) {
-                    float progress = glfwGetTime() - lastTimeEffect;
-                    drawSpriteEffect(TEXTURE_ASSET_ID::DOOM, EFFECT_ASSET_ID::EFFECT, vec4(1.f, 1.f, 1.f, 1.f - progress * 2.f), {window_width_px / 2, 280.f}, vec2(100.f) + (float) pow(progress * 40.f, 2));
+                if (battle_system->curr_battle_state == BattleSystem::STATE_EFFECT_PLAYING) {
+                    playEffect(battle_system->selectedAnime);
+                    if (battle_system->selectedAnime == BattleSystem::ALLY_DOOM && buffIndex == 1) {
+                        float progress = game_clock.now() - lastTimeEffect;
+                        drawSpriteEffect(TEXTURE_ASSET_ID::DOOM, EFFECT_ASSET_ID::EFFECT, vec4(1.f, 1.f, 1.f, 1.f - progress * 2.f), {window_width_px / 2, 280.f}, vec2(100.f) + (float) pow(progress * 40.f, 2));
+                    }
                 }
-            }
-            //drawMeshEffect(GEOMETRY_BUFFER_ID::PEBBLE, EFFECT_ASSET_ID::PARTICLE, vec4(1), {window_width_px / 2, window_height_px / 2}, 0, vec2(60.f + 5.f * sin(4.f * (float)glfwGetTime())));
+                //drawMeshEffect(GEOMETRY_BUFFER_ID::PEBBLE, EFFECT_ASSET_ID::PARTICLE, vec4(1), {window_width_px / 2, window_height_px / 2}, 0, vec2(60.f + 5.f * sin(4.f * (float)game_clock.now())));
 
-            for (auto const& rq : renderRequestsNonEntity) {
-                if (rq.used_geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT) {
-                    drawMeshEffect(rq.used_geometry, rq.used_effect, rq.color, rq.pos, rq.angle, rq.scale);
-                }
-                else if (rq.used_texture != TEXTURE_ASSET_ID::TEXTURE_COUNT) {
-                    drawSpriteEffect(rq.used_texture, rq.used_effect, rq.color, rq.pos, rq.scale);
+                for (auto const& rq : renderRequestsNonEntity) {
+                    if (rq.used_geometry != GEOMETRY_BUFFER_ID::GEOMETRY_COUNT) {
+                        drawMeshEffect(rq.used_geometry, rq.used_effect, rq.color, rq.pos, rq.angle, rq.scale);
+                    }
+                    else if (rq.used_texture != TEXTURE_ASSET_ID::TEXTURE_COUNT) {
+                        drawSpriteEffect(rq.used_texture, rq.used_effect, rq.color, rq.pos, rq.scale);
+                    }
                 }
             }
             break;
         case GAME_STATE_ID::TRANSITION:
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             float elapsedTime;
             if (lastTimeTransition == 0.f)
-                lastTimeTransition = (float)glfwGetTime();
-            elapsedTime = (float)glfwGetTime() - lastTimeTransition;
+                lastTimeTransition = (float)game_clock.now();
+            elapsedTime = (float)game_clock.now() - lastTimeTransition;
             if (elapsedTime > 1.5f) {
                 lastTimeTransition = 0.f;
                 *current_game_state = GAME_STATE_ID::BATTLE;
@@ -732,8 +777,7 @@ void RenderSystem::drawToScreen()
             ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.0f, 0.0f, 0.0f, 0.0f));
             ImGui::PushStyleVar(ImGuiStyleVar_WindowPadding, ImVec2(0.f, 0.f));
             ImGui::SetNextWindowPos(ImVec2(0.f, 0.f));
-            std::string s = "Battle Tutorial " + std::to_string(battle_tutorial_index);
-            ImGui::Begin(s.c_str(), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoBringToFrontOnFocus);
+            ImGui::Begin(ui_format("Battle Tutorial %d", battle_tutorial_index), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoBringToFrontOnFocus);
             ImGui::SetWindowSize(ImVec2(window_width_px* scale_x, window_height_px* scale_y));
             ImGui::Image((void*)texture_gl_handles[(intptr_t)battle_tutorials[battle_tutorial_index]], ImVec2(window_width_px* scale_x, window_height_px* scale_y));
             ImGui::PopStyleColor();
@@ -742,85 +786,222 @@ void RenderSystem::drawToScreen()
 
             createBattleTutorialButton(ImVec2(1330.f * scale_x, 31.f * scale_y));
 
-            ImGui::Render();
-            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+            renderImGui();
             break;
     }
 }
 
 void RenderSystem::saveData()
 {
-    // open save file for writing
-    std::ofstream os("../savedata.json");
-    cereal::JSONOutputArchive archive(os);
+    save_status = SaveStatus::SAVING;
+    writeSave(save_slots.selected(), [this](bool ok) {
+        save_status = SaveStatus::DONE;
+        // back to asking, so saving can be tried again
+        if (!ok && *current_game_state == GAME_STATE_ID::SAVE_DONE) {
+            save_status = SaveStatus::IDLE;
+            *current_game_state = GAME_STATE_ID::SAVE;
+        }
+    });
+}
+
+void RenderSystem::autosave()
+{
+    writeSave(save_journal.session().slot, nullptr);
+}
+
+void RenderSystem::writeSave(int slot, SaveService::Callback done)
+{
+    SaveData data;
 
     // save player's current position
     Motion player_motion = registry.motions.get(player);
-    float posX = player_motion.position.x;
-    float posY = player_motion.position.y;
-    archive(CEREAL_NVP(posX), CEREAL_NVP(posY));
+    data.posX = player_motion.position.x;
+    data.posY = player_motion.position.y;
 
     // save lake id
-    int lake_id = registry.lakes.get(player).id;
+    data.lake_id = registry.lakes.get(player).id;
     // save player flags
     Player player_info = registry.players.get(player);
-    bool ally1_recruited = player_info.ally1_recruited;
-    bool ally2_recruited = player_info.ally2_recruited;
-    bool shiny_tutorial = player_info.shiny_tutorial;
-    bool battle_tutorial_complete = player_info.battle_tutorial_complete;
-    bool lake1_boss_defeated = player_info.lake1_boss_defeated;
-    int num_fish_caught_lake1 = player_info.num_fish_caught_lake1;
-    int num_fish_caught_lake2 = player_info.num_fish_caught_lake2;
-    bool basic_tutorial_complete = player_info.basic_tutorial_complete;
-    bool fishing_tutorial_complete = player_info.fishing_tutorial_complete;
-    bool lake2_entered = player_info.lake2_entered;
-    archive(CEREAL_NVP(lake_id), CEREAL_NVP(ally1_recruited), CEREAL_NVP(ally2_recruited), CEREAL_NVP(shiny_tutorial), CEREAL_NVP(battle_tutorial_complete), CEREAL_NVP(lake1_boss_defeated),
-        CEREAL_NVP(num_fish_caught_lake1), CEREAL_NVP(num_fish_caught_lake2), CEREAL_NVP(basic_tutorial_complete), CEREAL_NVP(fishing_tutorial_complete), CEREAL_NVP(lake2_entered));
-   
+    data.ally1_recruited = player_info.ally1_recruited;
+    data.ally2_recruited = player_info.ally2_recruited;
+    data.shiny_tutorial = player_info.shiny_tutorial;
+    data.battle_tutorial_complete = player_info.battle_tutorial_complete;
+    data.lake1_boss_defeated = player_info.lake1_boss_defeated;
+    data.num_fish_caught_lake1 = player_info.num_fish_caught_lake1;
+    data.num_fish_caught_lake2 = player_info.num_fish_caught_lake2;
+    data.basic_tutorial_complete = player_info.basic_tutorial_complete;
+    data.fishing_tutorial_complete = player_info.fishing_tutorial_complete;
+    data.lake2_entered = player_info.lake2_entered;
+
     // save camera's current position
-    float cameraX = viewMatrix.mat[2][0];
-    float cameraY = viewMatrix.mat[2][1];
-    archive(CEREAL_NVP(cameraX), CEREAL_NVP(cameraY));
+    data.cameraX = viewMatrix.mat[2][0];
+    data.cameraY = viewMatrix.mat[2][1];
 
     // save current gold
-    Wallet player_wallet = registry.wallet.get(player);
-    int gold = player_wallet.gold;
-    archive(CEREAL_NVP(gold));
+    data.gold = registry.wallet.get(player).gold;
 
     // save current durability, attack, & defense
     Entity rod = registry.fishingRods.entities[0];
     Durability dur = registry.durabilities.get(rod);
     Attack atk = registry.attacks.get(rod);
     Defense def = registry.defenses.get(rod);
-    float dur_max = dur.max;
-    float dur_curr = dur.current;
-    float dur_upgrades = dur.num_upgrades;
-    int attack = atk.damage;
-    float attack_upgrades = atk.num_upgrades;
-    int defense = def.value;
-    archive(CEREAL_NVP(dur_max), CEREAL_NVP(dur_curr), CEREAL_NVP(dur_upgrades), CEREAL_NVP(attack), CEREAL_NVP(attack_upgrades), CEREAL_NVP(defense));
-
-    // save fishing inventory
-    uint64_t fish_inventory_size = registry.fishInventory.components.size();
-    std::vector<Fish> fishes = registry.fishInventory.components;
-    archive(CEREAL_NVP(fishes));
-
-    // save fishing log
-    std::vector<FishingLog> fishlog = registry.fishingLog.components;
-    archive(CEREAL_NVP(fishlog));
+    data.dur_max = dur.max;
+    data.dur_curr = dur.current;
+    data.dur_upgrades = dur.num_upgrades;
+    data.attack = atk.damage;
+    data.attack_upgrades = atk.num_upgrades;
+    data.defense = def.value;
+
+    // save fishing inventory and log
+    data.collection = fish_collection;
 
     // save current lake
-    archive(CEREAL_NVP(currently_lake_1));
-    archive(CEREAL_NVP(second_lake_unlocked));
+    data.currently_lake_1 = currently_lake_1;
+    data.second_lake_unlocked = second_lake_unlocked;
+
+    // what the menus show of the slot
+    SaveSlotInfo info;
+    info.used = true;
+    info.playtime_s = save_slots.playtime();
+    info.gold = data.gold;
+    info.lake_id = data.lake_id;
+    info.timestamp = (int64_t)std::time(nullptr);
+    captureThumbnail(info.thumbnail);
+    SaveSlotInfo previous = save_slots.info(slot);
+    std::string index = save_slots.set(slot, info);
+
+    // the journal starts over on top of this save
+    JournalSession journal = save_journal.session();
+    data.journal_id = save_journal.begin(slot);
+    uint64_t journal_id = data.journal_id;
+
+    save_service.save_async(slot, std::move(data), std::move(index), [slot, previous, journal, journal_id, done](bool ok) {
+        if (!ok) {
+            save_slots.set(slot, previous);
+            if (save_journal.session().id == journal_id)
+                save_journal.save_failed(journal);
+        }
+        if (done)
+            done(ok);
+    });
+}
+
+void RenderSystem::captureThumbnail(std::vector<unsigned char>& pixels)
+{
+    // the GPU scales the world pass down, only the thumbnail is read back
+    GLuint thumbnail_frame_buffer, thumbnail_render_buffer;
+    glGenFramebuffers(1, &thumbnail_frame_buffer);
+    glGenRenderbuffers(1, &thumbnail_render_buffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, thumbnail_render_buffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, SaveSlots::THUMBNAIL_WIDTH, SaveSlots::THUMBNAIL_HEIGHT);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, thumbnail_frame_buffer);
+    glFramebufferRenderbuffer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, thumbnail_render_buffer);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, frame_buffer);
+
+    int w, h;
+    getDrawableSize(w, h);
+    glBlitFramebuffer(0, 0, w, h, 0, 0, SaveSlots::THUMBNAIL_WIDTH, SaveSlots::THUMBNAIL_HEIGHT, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+    pixels.resize((size_t)SaveSlots::THUMBNAIL_WIDTH * SaveSlots::THUMBNAIL_HEIGHT * 3);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, thumbnail_frame_buffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, SaveSlots::THUMBNAIL_WIDTH, SaveSlots::THUMBNAIL_HEIGHT, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+    // back to the framebuffer drawToScreen() draws into
+    glBindFramebuffer(GL_FRAMEBUFFER, present_frame_buffer);
+    glDeleteRenderbuffers(1, &thumbnail_render_buffer);
+    glDeleteFramebuffers(1, &thumbnail_frame_buffer);
+    gl_has_errors();
+}
+
+void RenderSystem::drawSaveSlots(bool only_used)
+{
+    // upload the thumbnails again only when a slot changed
+    if (slot_thumbnails_revision != save_slots.revision()) {
+        slot_thumbnails_revision = save_slots.revision();
+        for (int slot = 0; slot < SaveSlots::SLOT_COUNT; slot++) {
+            const SaveSlotInfo& info = save_slots.info(slot);
+            if (info.thumbnail.size() != (size_t)SaveSlots::THUMBNAIL_WIDTH * SaveSlots::THUMBNAIL_HEIGHT * 3)
+                continue;
+            if (slot_thumbnails[slot] == 0)
+                glGenTextures(1, &slot_thumbnails[slot]);
+            glBindTexture(GL_TEXTURE_2D, slot_thumbnails[slot]);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, SaveSlots::THUMBNAIL_WIDTH, SaveSlots::THUMBNAIL_HEIGHT, 0, GL_RGB, GL_UNSIGNED_BYTE, info.thumbnail.data());
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            gl_has_errors();
+        }
+    }
+
+    // a column of slots on the wood left of the dialog
+    float thumbnail_width = (float)SaveSlots::THUMBNAIL_WIDTH * scale_x;
+    float thumbnail_height = (float)SaveSlots::THUMBNAIL_HEIGHT * scale_y;
+    float card_height = thumbnail_height + 70.f * scale_y;
+    ImGui::SetNextWindowPos(ImVec2(25.f * scale_x, 170.f * scale_y));
+    ImGui::SetNextWindowSize(ImVec2(thumbnail_width + 20.f * scale_x, card_height * SaveSlots::SLOT_COUNT + 20.f * scale_y));
+    ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.3f, 0.2f, 0.12f, 0.85f));
+    ImGui::Begin("Save Slots", NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoCollapse);
+    ImGui::PushFont(font_small);
+    for (int slot = 0; slot < SaveSlots::SLOT_COUNT; slot++) {
+        const SaveSlotInfo& info = save_slots.info(slot);
+        ImGui::PushID(slot);
+        ImVec2 p = ImGui::GetCursorScreenPos();
+        ImGui::BeginDisabled(only_used && !info.used);
+        if (ImGui::InvisibleButton("##Slot", ImVec2(thumbnail_width, card_height - 10.f * scale_y)))
+            save_slots.select(slot);
+        bool hovered = ImGui::IsItemHovered();
+        ImGui::EndDisabled();
+        if (slot == save_slots.selected() || hovered) {
+            ImU32 color = slot == save_slots.selected() ? IM_COL32(230, 180, 80, 255) : IM_COL32(155, 103, 60, 255);
+            ImGui::GetWindowDrawList()->AddRect(ImVec2(p.x - 4.f, p.y - 4.f), ImVec2(p.x + thumbnail_width + 4.f, p.y + card_height - 6.f * scale_y), color, 4.f, 0, 3.f);
+        }
+        ImGui::SetCursorScreenPos(p);
+        if (info.used && slot_thumbnails[slot] != 0) {
+            // the thumbnail rows start at the bottom, like the framebuffer they were read from
+            ImGui::Image((void*)(intptr_t)slot_thumbnails[slot], ImVec2(thumbnail_width, thumbnail_height), ImVec2(0, 1), ImVec2(1, 0));
+        } else {
+            ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(thumbnail_width, thumbnail_height));
+        }
+        if (info.used) {
+            int minutes = (int)(info.playtime_s / 60.0);
+            ImGui::Text("Slot %d - Lake %d", slot + 1, info.lake_id);
+            ImGui::Text("%d gold, %d:%02d played", info.gold, minutes / 60, minutes % 60);
+            char date[32] = "";
+            time_t timestamp = (time_t)info.timestamp;
+            if (info.timestamp > 0)
+                strftime(date, sizeof(date), "%Y-%m-%d %H:%M", std::localtime(&timestamp));
+            ImGui::Text("%s", date);
+        } else {
+            ImGui::Text("Slot %d - Empty", slot + 1);
+        }
+        ImGui::SetCursorScreenPos(ImVec2(p.x, p.y + card_height));
+        ImGui::PopID();
+    }
+    ImGui::PopFont();
+    ImGui::End();
+    ImGui::PopStyleColor();
 }
 
 // Render our game world
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 void RenderSystem::draw()
 {
+    render_stats.new_frame();
+    gpu_profiler.begin_frame();
+    frame_profiler.begin_zone("world pass");
+    gpu_profiler.begin_zone("world pass");
     // Getting size of window
     int w, h;
-    glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+    getDrawableSize(w, h);
+
+    // the world pass only draws what the simulation captured, never the live registry
+    const RenderSnapshot& snapshot = render_snapshot;
+
+    // the camera is blended between simulation steps like the motions
+    interpolated_view = snapshot.view;
+    interpolated_view.mat[2][0] = snapshot.previous_view.mat[2][0] + (snapshot.view.mat[2][0] - snapshot.previous_view.mat[2][0]) * interpolation_alpha;
+    interpolated_view.mat[2][1] = snapshot.previous_view.mat[2][1] + (snapshot.view.mat[2][1] - snapshot.previous_view.mat[2][1]) * interpolation_alpha;
 
     // First render to the custom framebuffer
     glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
@@ -839,50 +1020,74 @@ void RenderSystem::draw()
     gl_has_errors();
     mat3 projection_2D = createProjectionMatrix();
     // Draw all textured meshes that have a position and size component
-    // registry.renderRequests.entities
-
-    registry.renderRequests.sort([ ](Entity& lhs, Entity& rhs)
+    for (const RenderSnapshot::Item& item : snapshot.items)
     {
-    	int left = registry.players.has(lhs) ? 1 : 0;
-        int right = registry.players.has(rhs) ? 1 : 0;
-        return left < right;
-    });
+        if (item.is_sprite) {
+            drawSpriteAnime(item.frame, item.rows, item.columns, item.texture, item.interpolated_position(interpolation_alpha), item.scale, 0.f, false, item.light_up);
 
-    for (Entity entity : registry.renderRequests.entities)
-    {
-       if (registry.motions.has(entity)) {
-		   if (registry.sprites.has(entity)) {
-			   Sprite& sprite = registry.sprites.get(entity);
-			   Motion& motion = registry.motions.get(entity);
-			   TEXTURE_ASSET_ID texture_id = registry.renderRequests.get(entity).used_texture;
-			   drawSpriteAnime(sprite.current_frame, sprite.rows, sprite.columns, texture_id, motion.position, motion.scale, 0.f, false);
-
-               const GLuint used_effect_enum = (GLuint)EFFECT_ASSET_ID::TEXTURED;
-               const GLuint program = (GLuint)effects[used_effect_enum];
-               GLuint light_up_uloc = glGetUniformLocation(program, "light_up");
-               assert(light_up_uloc >= 0);
-               glUniform1i(light_up_uloc, 0);
-               gl_has_errors();
-		   }
-		   else {
-               if (registry.renderRequests.get(entity).is_visible == true) {
-                   drawTexturedMesh(entity, projection_2D);
-               }
-		   }
-       }
+            const GLuint used_effect_enum = (GLuint)EFFECT_ASSET_ID::TEXTURED;
+            const GLuint program = (GLuint)effects[used_effect_enum];
+            GLuint light_up_uloc = glGetUniformLocation(program, "light_up");
+            assert(light_up_uloc >= 0);
+            glUniform1i(light_up_uloc, 0);
+            gl_has_errors();
+        }
+        else {
+            drawTexturedMesh(item, projection_2D);
+        }
     }
+    gpu_profiler.end_zone();
+    frame_profiler.end_zone();
     // Truely render to the screen
     drawToScreen();
-	// flicker-free display with a double buffer
-	glfwSwapBuffers(window);
+	// flicker-free display with a double buffer, nothing to present when headless
+	if (present_frame_buffer == 0) {
+		PROFILE_ZONE("glfwSwapBuffers");
+		glfwSwapBuffers(window);
+	}
 	gl_has_errors();
 }
 
+void RenderSystem::getDrawableSize(int& w, int& h) const
+{
+	if (launch_options.headless) {
+		w = launch_options.headless_width;
+		h = launch_options.headless_height;
+		return;
+	}
+	glfwGetFramebufferSize(window, &w, &h); // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+}
+
+bool RenderSystem::saveScreenshot(const std::string& path)
+{
+	if (present_frame_buffer == 0)
+		return false;
+	int w, h;
+	getDrawableSize(w, h);
+	std::vector<unsigned char> pixels((size_t)w * h * 3);
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, present_frame_buffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, w, h, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+	gl_has_errors();
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == nullptr) {
+		fprintf(stderr, "Could not write screenshot to %s\n", path.c_str());
+		return false;
+	}
+	fprintf(file, "P6\n%d %d\n255\n", w, h);
+	// GL rows start at the bottom, PPM rows at the top
+	for (int y = h - 1; y >= 0; y--)
+		fwrite(&pixels[(size_t)y * w * 3], 1, (size_t)w * 3, file);
+	fclose(file);
+	return true;
+}
+
 void RenderSystem::drawRoundBanner() {
     if (!battle_system->initialized)
         return;
     float alpha = 1.f;
-    float time = (float)glfwGetTime();
+    float time = (float)game_clock.now();
     if (lastTimeBanner == 0.0f || time - lastTimeBanner < 0) {
         lastTimeBanner = (float)time;
     }
@@ -893,8 +1098,7 @@ void RenderSystem::drawRoundBanner() {
     }
     if ((time - lastTimeBanner) > 1.3f) {
        lastTimeBanner = 0.0f;
-       //note: make sure currMember here is not the previous acted, but the upcoming character (ie update currMember immediately when previous char's action ends)
-       if (battle_system->allMembers[battle_system->currMemberIndex].actionIndex < battle_system->enemy->actionIndex) {
+       if (battle_system->roundBeginTurn() == BattleCore::Turn::PLAYER) {
             battle_system->curr_battle_state = BattleSystem::StateEnum::STATE_PLAYER_TURN;
        }
        else {
@@ -913,14 +1117,14 @@ void RenderSystem::drawRoundBanner() {
 
     ImGui::SetCursorPos(textPosition);
     ImGui::SetWindowFontScale(1.7f);
-    ImGui::TextColored(ImVec4(0.9804f, 0.9137f, 0.7647f, alpha), "Round %s", std::to_string(battle_system->roundCounter).c_str());
+    ImGui::TextColored(ImVec4(0.9804f, 0.9137f, 0.7647f, alpha), "Round %d", battle_system->roundCounter);
     ImGui::PopStyleColor();
     ImGui::PopStyleVar();
     ImGui::End();
 }
 
 void RenderSystem::drawPlayerAnime() {
-    float time = (float)glfwGetTime();
+    float time = (float)game_clock.now();
     float frameDuration = 0.3f; // Time in seconds for each frame
     int numFrames = 12;
     int currentFrame = static_cast<int>(time / frameDuration) % numFrames;
@@ -990,6 +1194,8 @@ void RenderSystem::drawPlayerAnime() {
     textured_vertices[2].texcoord = { 1.f, 0.f };
     textured_vertices[3].texcoord = { 0.f, 0.f };
     glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(textured_vertices[0]) * textured_vertices.size(), textured_vertices.data());
+    render_stats.buffer_uploads++;
+    render_stats.buffer_upload_bytes += sizeof(textured_vertices[0]) * textured_vertices.size();
     gl_has_errors();
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
     gl_has_errors();
@@ -1070,7 +1276,7 @@ void RenderSystem::drawDmgText(const char* text, ImVec2 position, ImU32 textColo
     ImGui::End();
 }
 
-void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEXTURE_ASSET_ID texture_asset_id, vec2 screen_position, vec2 scale, float darken, bool use_screen_matrix) {
+void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEXTURE_ASSET_ID texture_asset_id, vec2 screen_position, vec2 scale, float darken, bool use_screen_matrix, bool light_up) {
 
     mat3 projection_2D = createProjectionMatrix();
     Transform transform;
@@ -1100,6 +1306,8 @@ void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEX
 	sprite_sheet_vertices[2].texcoord = { (1.0f / num_columns) * (frame % num_columns + 1), (1.0f / num_rows) * ((frame / num_columns) % num_rows) }; // top right
 	sprite_sheet_vertices[3].texcoord = { (1.0f / num_columns) * (frame % num_columns), (1.0f / num_rows) * ((frame / num_columns) % num_rows) }; //top left
 	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(sprite_sheet_vertices[0]) * sprite_sheet_vertices.size(), sprite_sheet_vertices.data());
+	render_stats.buffer_uploads++;
+	render_stats.buffer_upload_bytes += sizeof(sprite_sheet_vertices[0]) * sprite_sheet_vertices.size();
 	gl_has_errors();
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo);
@@ -1115,7 +1323,8 @@ void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEX
 
     // !!! TODO A1: set the light_up shader variable using glUniform1i,
     // similar to the glUniform1f call below. The 1f or 1i specified the type, here a single int.
-    if (registry.lightUp.has(player) && (texture_asset_id == TEXTURE_ASSET_ID::PLAYER_LEFT_SHEET || texture_asset_id == TEXTURE_ASSET_ID::PLAYER_RIGHT_SHEET || texture_asset_id == TEXTURE_ASSET_ID::PLAYER_UP_SHEET || texture_asset_id == TEXTURE_ASSET_ID::PLAYER_DOWN_SHEET)) {
+    // the player glows while on a shiny spot, decided when the render snapshot is captured
+    if (light_up) {
         glUniform1i(light_up_uloc, 1);
     }
     else {
@@ -1149,6 +1358,7 @@ void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEX
 		texture_gl_handles[(GLuint)texture_asset_id];
 
     glBindTexture(GL_TEXTURE_2D, texture_id);
+    render_stats.texture_binds++;
     gl_has_errors();
 
     // Getting uniform locations for glUniform* calls
@@ -1182,9 +1392,10 @@ void RenderSystem::drawSpriteAnime(int frame, int num_rows, int num_columns, TEX
         glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&viewScreenMatrix);
     }
     else {
-        glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&viewMatrix);
+        glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&interpolated_view);
     }
     glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr);
+    render_stats.draw_calls++;
     gl_has_errors();
 
 }
@@ -1257,6 +1468,7 @@ void RenderSystem::drawMeshEffect(GEOMETRY_BUFFER_ID geo_id, EFFECT_ASSET_ID eff
     // rod idle depends on screen, not camera position
     glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&viewScreenMatrix);
     glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr);
+    render_stats.draw_calls++;
     gl_has_errors();
 }
 
@@ -1310,6 +1522,7 @@ void RenderSystem::drawSpriteEffect(TEXTURE_ASSET_ID id, EFFECT_ASSET_ID eff_id,
             texture_gl_handles[(GLuint)id];
 
     glBindTexture(GL_TEXTURE_2D, texture_id);
+    render_stats.texture_binds++;
     glUniform1i(glGetUniformLocation(program, "inputTexture"), 0);
     gl_has_errors();
 
@@ -1341,6 +1554,7 @@ void RenderSystem::drawSpriteEffect(TEXTURE_ASSET_ID id, EFFECT_ASSET_ID eff_id,
     // rod idle depends on screen, not camera position
     glUniformMatrix3fv(view_loc, 1, GL_FALSE, (float*)&viewScreenMatrix);
     glDrawElements(GL_TRIANGLES, num_indices, GL_UNSIGNED_SHORT, nullptr);
+    render_stats.draw_calls++;
     gl_has_errors();
 
 }
@@ -1386,16 +1600,14 @@ void RenderSystem::playEnemyAnime(BattleSystem::AnimeEnum i) {
     case BattleSystem::AnimeEnum::ENEMY_EXECUTION:
     case BattleSystem::AnimeEnum::ENEMY_DEBUFF:
     case BattleSystem::AnimeEnum::ENEMY_ATK:
-        time = (float) glfwGetTime();
+        time = (float) game_clock.now();
         if (lastTimeEnemy == 0.0f) {
             lastTimeEnemy = time;
         }
         elapsedTime = time - lastTimeEnemy;
         if (elapsedTime > (2.f * M_PI / 5.f)) {
             lastTimeEnemy = 0.0f;
-            while (!renderRequestsNonEntity.empty()) {
-                renderRequestsNonEntity.pop_back();
-            }
+            renderRequestsNonEntity.clear();
             battle_system->curr_battle_state = BattleSystem::StateEnum::STATE_EFFECT_PLAYING;
         }
 
@@ -1413,7 +1625,7 @@ void RenderSystem::playEnemyAnime(BattleSystem::AnimeEnum i) {
         int index = -1;
         if (lastTimeEnemy != 0 && battle_system->enemy->skills[battle_system->enemySelectedSkill].skill_name == "Throw Salmon") {
             //draw the salmon
-            for (RenderRequestsNonEntity rq : renderRequestsNonEntity) {
+            for (const RenderRequestsNonEntity& rq : renderRequestsNonEntity) {
                 if (rq.id == "Salmon")
                     hasEffect = true;
                 index++;
@@ -1426,7 +1638,7 @@ void RenderSystem::playEnemyAnime(BattleSystem::AnimeEnum i) {
             }
         }
         else if (lastTimeEnemy != 0 && battle_system->enemy->skills[battle_system->enemySelectedSkill].skill_name == "Execution") {
-            for (RenderRequestsNonEntity rq : renderRequestsNonEntity) {
+            for (const RenderRequestsNonEntity& rq : renderRequestsNonEntity) {
                 if (rq.id == "Execution")
                     hasEffect = true;
                 index++;
@@ -1449,7 +1661,7 @@ void RenderSystem::playEnemyAnime(BattleSystem::AnimeEnum i) {
 void RenderSystem::playEffect(BattleSystem::AnimeEnum i) {
     if (!battle_system->initialized)
         return;
-    float time = (float) glfwGetTime();
+    float time = (float) game_clock.now();
     float elapsedTime;
     float progress;
     if (lastTimeEffect == 0.0f) {
@@ -1693,7 +1905,7 @@ void RenderSystem::createEnemy() {
     if (battle_system->curr_battle_state == BattleSystem::StateEnum::STATE_EFFECT_PLAYING) {
         snprintf(hpTextEnemy, sizeof(hpTextEnemy), "%.0f/%.0f", battle_system->enemySpecies.health, battle_system->enemyMaxHealth);
         hpFillEnemy = battle_system->enemySpecies.health / battle_system->enemyMaxHealth;
-        float time = (float)glfwGetTime();
+        float time = (float)game_clock.now();
         float elapsedTime;
         float progress;
         if (lastTimeText == 0.0f || time - lastTimeText < 0) {
@@ -1704,7 +1916,7 @@ void RenderSystem::createEnemy() {
             lastTimeText = 0.f;
         }
         if (!battle_system->dmgVals.targetPlayer && battle_system->dmgVals.shouldDisplay == true) {
-            drawDmgText(std::to_string(static_cast<int>(battle_system->dmgVals.value)).c_str(), ImVec2((950.f + 60 * elapsedTime) * scale_x, (310.f - 20 * elapsedTime + 60.f * elapsedTime * elapsedTime) * scale_y), battle_system->dmgVals.textColour);
+            drawDmgText(ui_format("%d", static_cast<int>(battle_system->dmgVals.value)), ImVec2((950.f + 60 * elapsedTime) * scale_x, (310.f - 20 * elapsedTime + 60.f * elapsedTime * elapsedTime) * scale_y), battle_system->dmgVals.textColour);
         }
     }
 
@@ -1728,7 +1940,7 @@ void RenderSystem::createEnemy() {
     }
     else if (battle_system->curr_battle_state == BattleSystem::STATE_ENEMY_DEFEATED) {
         float alpha = 1.f;
-        float time = (float)glfwGetTime();
+        float time = (float)game_clock.now();
         if (lastTimeEnemy == 0.0f) {
             lastTimeEnemy = (float)time;
         }
@@ -1757,7 +1969,7 @@ void RenderSystem::createEnemy() {
     }
     else
     {
-        float time = (float) glfwGetTime();
+        float time = (float) game_clock.now();
         float oscillationValue = 0.25f * std::sin(2.f * M_PI / 4.f * time) + 1.5f;
         ImVec2 spriteSize = ImVec2(390.f, 390.f);
         ImGui::PushStyleColor(ImGuiCol_WindowBg, ImVec4(0.f, 0.f, 0.f, 0.f));
@@ -1799,7 +2011,7 @@ void RenderSystem::createHPBar() {
     if (battle_system->curr_battle_state == BattleSystem::StateEnum::STATE_EFFECT_PLAYING) {
         hpFill = battle_system->currHealth / battle_system->maxHealth;
         snprintf(hpText, sizeof(hpText), "%.0f/%.0f", battle_system->currHealth, battle_system->maxHealth);
-        float time = (float)glfwGetTime();
+        float time = (float)game_clock.now();
         float elapsedTime;
         float progress;
         if (lastTimeText == 0.0f) {
@@ -1809,7 +2021,7 @@ void RenderSystem::createHPBar() {
         if (elapsedTime > 2.f)
             lastTimeText = 0.f;
         if (battle_system->dmgVals.targetPlayer && battle_system->dmgVals.shouldDisplay == true) {
-            drawDmgText(std::to_string(static_cast<int>(battle_system->dmgVals.value)).c_str(), ImVec2((300.f + 60 * elapsedTime) * scale_x, (760.f - 20 * elapsedTime + 60.f * elapsedTime * elapsedTime) * scale_y), battle_system->dmgVals.textColour);
+            drawDmgText(ui_format("%d", static_cast<int>(battle_system->dmgVals.value)), ImVec2((300.f + 60 * elapsedTime) * scale_x, (760.f - 20 * elapsedTime + 60.f * elapsedTime * elapsedTime) * scale_y), battle_system->dmgVals.textColour);
         }
     }
 	drawList->AddRectFilled(position, ImVec2(position.x + size.x, position.y + size.y), IM_COL32(59, 94, 126, 255));
@@ -1829,11 +2041,9 @@ void RenderSystem::createCharacterPortrait(ImVec2 position, int index) {
 	ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 5.f); // brown border thickness
 	ImGui::SetNextWindowPos(position); // set block position
 	ImGui::SetNextWindowSize(ImVec2(195.f * scale_x, 205.f * scale_y)); // set block size
-    std::string text = "Character portrait" + std::to_string(index);
-	ImGui::Begin(text.c_str(), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar);
+	ImGui::Begin(ui_format("Character portrait%d", index), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar);
 
-    std::vector<Entity> members = registry.partyMembers.entities;
-    PartyMember p = registry.partyMembers.get(members[index]);
+    const PartyMember& p = registry.partyMembers.components[index];
 
     ImVec2 textSize = ImGui::CalcTextSize(p.name.c_str());
 	//ImGui::SetWindowFontScale(1.5f);
@@ -1847,7 +2057,7 @@ void RenderSystem::createCharacterPortrait(ImVec2 position, int index) {
 }
 
 void RenderSystem::drawPortraitsAnime(float xpos, TEXTURE_ASSET_ID asset_id) {
-    float time = (float)glfwGetTime();
+    float time = (float)game_clock.now();
     float frameDuration = 0.7f; // Time in seconds for each frame
     int numFrames = 2;
     int currentFrame = static_cast<int>(time / frameDuration) % numFrames;
@@ -1855,18 +2065,11 @@ void RenderSystem::drawPortraitsAnime(float xpos, TEXTURE_ASSET_ID asset_id) {
 }
 
 void RenderSystem::createSkillsTable() {
-    std::vector<std::string> actionNames;
-    std::vector<std::string> actionDescription;
-
-    if (battle_system->currMemberIndex != -1 && battle_system->allMembers[battle_system->currMemberIndex].skills.size() != 0) {
-        for (int i = 0; i < battle_system->allMembers[battle_system->currMemberIndex].skills.size(); i++) {
-            actionNames.push_back(battle_system->allMembers[battle_system->currMemberIndex].skills[i].skill_name);
-            actionDescription.push_back(battle_system->allMembers[battle_system->currMemberIndex].skills[i].skill_description);
-        }
-    }
-    else {
+    if (battle_system->currMemberIndex == -1 || battle_system->allMembers[battle_system->currMemberIndex].skills.size() == 0) {
         return;
     }
+    // shown straight from the member, no copies
+    const std::vector<Skill>& skills = battle_system->allMembers[battle_system->currMemberIndex].skills;
 	const int numColumns = 2; // Number of columns in the grid
 	// select skill using keyboard
 	//if (ImGui::IsKeyPressed(ImGuiKey_W)) {
@@ -1928,7 +2131,7 @@ void RenderSystem::createSkillsTable() {
 	ImGui::SetNextWindowPos(ImVec2(270.f * scale_x, 705.f * scale_y)); // set block position
 	ImGui::SetNextWindowSize(ImVec2(1183.f * scale_x, 105.f * scale_y)); // set block size
 	ImGui::Begin("Skills Options", NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoBringToFrontOnFocus);
-	for (int i = 0; i < actionNames.size(); ++i) {
+	for (int i = 0; i < skills.size(); ++i) {
 		if (i % numColumns != 0) {
 			ImGui::SameLine(); // Start a new row
 		}
@@ -1950,7 +2153,7 @@ void RenderSystem::createSkillsTable() {
         ImGui::PushStyleColor(ImGuiCol_ButtonHovered, battle_blue_highlighted);
         ImGui::PushStyleColor(ImGuiCol_ButtonActive, battle_blue_highlighted);
 		//ImGui::SetWindowFontScale(1.2f);
-		if (ImGui::Button(actionNames[i].c_str(), ImVec2(595.f * scale_x, 48.f * scale_y))) {
+		if (ImGui::Button(skills[i].skill_name.c_str(), ImVec2(595.f * scale_x, 48.f * scale_y))) {
 			// this is for clicks, do nothing
             if (battle_system->curr_battle_state == BattleSystem::STATE_PLAYER_TURN) {
                 battle_system->selectedSkill = i;
@@ -1969,7 +2172,7 @@ void RenderSystem::createSkillsTable() {
             ImGui::SetNextWindowSize(ImVec2(650.f, 80.f));
             ImGui::BeginTooltip();
             ImGui::SetWindowFontScale(0.7f);
-            ImGui::TextWrapped(actionDescription[i].c_str());
+            ImGui::TextWrapped("%s", skills[i].skill_description.c_str());
             ImGui::EndTooltip();
         }
         ImGui::PopStyleVar(2);
@@ -2006,28 +2209,28 @@ void RenderSystem::createBattleLog() {
 	ImGui::SetCursorPos(ImVec2(5.f * scale_x, 5.f * scale_y));
     switch (battle_system->curr_battle_state) {
         case BattleSystem::StateEnum::STATE_PLAYER_TURN:
-            battleLogText = battle_system->allMembers[battle_system->currMemberIndex].name + "'s turn";
+            snprintf(battleLogText, sizeof(battleLogText), "%s's turn", battle_system->allMembers[battle_system->currMemberIndex].name.c_str());
             break;
         case BattleSystem::StateEnum::STATE_PLAYER_ACTING:
-            battleLogText = battle_system->allMembers[battle_system->currMemberIndex].name + " is acting...";
+            snprintf(battleLogText, sizeof(battleLogText), "%s is acting...", battle_system->allMembers[battle_system->currMemberIndex].name.c_str());
             break;
         case BattleSystem::StateEnum::STATE_ENEMY_ACTING:
             if (battle_system->enemySelectedSkill != -1)
-                battleLogText = battle_system->enemySpecies.name + " uses " + battle_system->enemy->skills[battle_system->enemySelectedSkill].skill_name;
+                snprintf(battleLogText, sizeof(battleLogText), "%s uses %s", battle_system->enemySpecies.name.c_str(), battle_system->enemy->skills[battle_system->enemySelectedSkill].skill_name.c_str());
             break;
         case BattleSystem::StateEnum::STATE_ROUND_BEGIN:
-            battleLogText = "new round begins...";
+            snprintf(battleLogText, sizeof(battleLogText), "new round begins...");
             break;
         case BattleSystem::StateEnum::STATE_ENEMY_DEFEATED:
-            battleLogText = battle_system->enemySpecies.name + " has been defeated!";
+            snprintf(battleLogText, sizeof(battleLogText), "%s has been defeated!", battle_system->enemySpecies.name.c_str());
             break;
         case BattleSystem::StateEnum::STATE_PLAYER_DEFEATED:
-            battleLogText = "The fishing line has been broken!";
+            snprintf(battleLogText, sizeof(battleLogText), "The fishing line has been broken!");
             break;
     }
-    ImGui::Text(battleLogText.c_str());
+    ImGui::TextUnformatted(battleLogText);
     /*ImGui::SetCursorPos(ImVec2(5.f * scale_x, 25.f * scale_y));
-    ImGui::Text(battleLogText.c_str());*/
+    ImGui::TextUnformatted(battleLogText);*/
 	ImGui::PopStyleColor(2);
 	ImGui::PopStyleVar(2);
 	ImGui::End();
@@ -2154,36 +2357,47 @@ void RenderSystem::drawInventory()
             if (ImGui::BeginTable("Fish Inventory", num_columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedSame | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
             {
                 ImGui::PushFont(font_small);
-                int inventoryIndex = 0;
-                auto &fish_inventory = registry.fishInventory;
-                for (int row = 0; row < 6; row++)
+                // a cell per species owned with the number owned on it, at least 6 rows of
+                // cells, and only the rows in view are drawn
+                int* stacks = frame_arena.allocate_array<int>(fish_collection.species_count());
+                int num_stacks = fish_collection.owned_species(stacks);
+                int num_rows = std::max(6, (num_stacks + num_columns - 1) / num_columns);
+                ImGuiListClipper clipper;
+                clipper.Begin(num_rows);
+                while (clipper.Step())
                 {
-                    ImGui::TableNextRow();
-                    for (int column = 0; column < num_columns; column++)
+                    for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
                     {
-                        ImGui::TableSetColumnIndex(column);
-                        ImVec2 p = ImGui::GetCursorScreenPos();
-                        if (inventoryIndex < fish_inventory.size())
+                        ImGui::TableNextRow();
+                        for (int column = 0; column < num_columns; column++)
                         {
-                            Fish &fish = fish_inventory.components[inventoryIndex];
-                            ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
-                            FishSpecies species = id_to_fish_species.at(fish.species_id);
-                            // different species should have different textures
-                            ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)fish.species_id], ImVec2(item_size, item_size));
-
-                            if (ImGui::IsItemHovered())
+                            int cell = row * num_columns + column;
+                            ImGui::TableSetColumnIndex(column);
+                            ImVec2 p = ImGui::GetCursorScreenPos();
+                            if (cell < num_stacks)
                             {
-                                ImGui::SetTooltip(species.name.c_str());
+                                int species_id = stacks[cell];
+                                int owned = fish_collection.owned(species_id);
+                                ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
+                                // different species should have different textures
+                                ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[species_id], ImVec2(item_size, item_size));
+
+                                if (ImGui::IsItemHovered())
+                                {
+                                    ImGui::SetTooltip("%s (%d owned)", species_name(species_id), owned);
+                                }
+                                // the size of the stack in the corner of the cell
+                                const char* count = ui_format("x%d", owned);
+                                ImVec2 count_size = ImGui::CalcTextSize(count);
+                                ImGui::GetWindowDrawList()->AddText(ImVec2(p.x + item_size - count_size.x - 6.f, p.y + item_size - count_size.y - 2.f), IM_COL32(0, 0, 0, 255), count);
                             }
-                            inventoryIndex++;
-                        }
-                        else
-                        {
-                            // ImGui::GetWindowDrawList()->AddImage((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + 103.f, p.y + 102.f), ImVec2(0, 0), ImVec2(1, 1));
-                            ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(item_size, item_size));
-                            if (ImGui::IsItemHovered())
+                            else
                             {
-                                ImGui::SetTooltip("Empty");
+                                ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(item_size, item_size));
+                                if (ImGui::IsItemHovered())
+                                {
+                                    ImGui::SetTooltip("Empty");
+                                }
                             }
                         }
                     }
@@ -2232,7 +2446,7 @@ void RenderSystem::drawInventory()
 
                             if (ImGui::IsItemHovered())
                             {
-                                ImGui::SetTooltip((lure.name + ": " + std::to_string(lure.numOwned)).c_str());
+                                ImGui::SetTooltip("%s: %d", lure.name.c_str(), lure.numOwned);
                             }
                             inventoryIndex++;
                         }
@@ -2272,13 +2486,13 @@ void RenderSystem::drawInventory()
                             Gift &gift = inventory.components[inventoryIndex];
                             ImVec2 p = ImGui::GetCursorScreenPos();
                             ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
-                            GiftType species = id_to_gift_type.at(gift.type);
+                            const GiftType& species = id_to_gift_type.at(gift.type);
                             // different species should have different textures
                             ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)species.id], ImVec2(item_size, item_size));
 
                             if (ImGui::IsItemHovered())
                             {
-                                ImGui::SetTooltip(species.name.c_str());
+                                ImGui::SetTooltip("%s", species.name.c_str());
                             }
 
                             inventoryIndex++;
@@ -2311,172 +2525,17 @@ void RenderSystem::drawInventory()
 
         if (ImGui::BeginTabItem("ALL"))
         {
-            if (ImGui::BeginTable("All Fish", num_columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedSame | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
-            {
-                ImGui::PushFont(font_small);
-                std::map<int, int> fishSpeciesCount;
-                auto &fishingLog = registry.fishingLog;
-                for (uint i = 0; i < fishingLog.size(); i++)
-                {
-                    FishingLog &fish = fishingLog.components[i];
-                    ++fishSpeciesCount[fish.species_id];
-                }
-
-                for (int row = 0; row < 6; row++)
-                {
-                    ImGui::TableNextRow();
-                    for (int column = 0; column < 12; column++)
-                    {
-                        int cell_count = row * 12 + column;
-                        ImGui::TableSetColumnIndex(column);
-                        ImVec2 p = ImGui::GetCursorScreenPos();
-                        ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
-
-                        if (fishSpeciesCount.find(cell_count) == fishSpeciesCount.end())
-                        {
-                            // not found
-                            // ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(103.f, 102.f));
-                            ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::CHINOOK_SHADOW], ImVec2(item_size, item_size));
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip("???");
-                            }
-                        }
-                        else
-                        {
-                            // found
-                            FishSpecies species = id_to_fish_species.at(cell_count);
-                            // different species should have different textures
-                            ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)cell_count], ImVec2(item_size, item_size));
-
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip(species.name.c_str());
-                            }
-                        }
-                    }
-                }
-                ImGui::PopFont();
-                ImGui::EndTable();
-            }
+            drawFishLogTable("All Fish", 0, num_columns, item_size);
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("LAKE 1"))
         {
-            if (ImGui::BeginTable("Lake 1 Fish", num_columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedSame | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
-            {
-                ImGui::PushFont(font_small);
-                std::map<int, int> fishSpeciesCount;
-                auto &inventory = registry.fishingLog;
-                for (uint i = 0; i < inventory.size(); i++)
-                {
-                    FishingLog &fish = inventory.components[i];
-                    if (fish.lake_id == 1)
-                    { // TODO: unhardcode this
-                        ++fishSpeciesCount[fish.species_id];
-                    }
-                }
-                for (int row = 0; row < 6; row++)
-                {
-                    ImGui::TableNextRow();
-                    for (int column = 0; column < num_columns; column++)
-                    {
-                        // ImGui::TableSetColumnIndex(column);
-                        // // This commented out code is how to set the background of the cell
-                        // /*ImVec2 p = ImGui::GetCursorScreenPos();
-                        // ImGui::GetWindowDrawList()->AddImage((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + 104.f, p.y + 102.f), ImVec2(0, 0), ImVec2(1, 1));*/
-                        // ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(103.f, 102.f));
-                        int cell_count = row * num_columns + column;
-                        ImGui::TableSetColumnIndex(column);
-                        ImVec2 p = ImGui::GetCursorScreenPos();
-                        ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
-
-                        if (fishSpeciesCount.find(cell_count) == fishSpeciesCount.end())
-                        {
-                            // not found
-                            // ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(103.f, 102.f));
-                            ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::CHINOOK_SHADOW], ImVec2(item_size, item_size));
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip("???");
-                            }
-                        }
-                        else
-                        {
-                            // found
-                            FishSpecies species = id_to_fish_species.at(cell_count);
-                            // different species should have different textures
-                            ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)cell_count], ImVec2(item_size, item_size));
-
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip(species.name.c_str());
-                            }
-                        }
-                    }
-                }
-                ImGui::PopFont();
-                ImGui::EndTable();
-            }
+            drawFishLogTable("Lake 1 Fish", 1, num_columns, item_size);
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("LAKE 2"))
         {
-            if (ImGui::BeginTable("Lake 2 Fish", num_columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedSame | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
-            {
-                ImGui::PushFont(font_small);
-                std::map<int, int> fishSpeciesCount;
-                auto &inventory = registry.fishingLog;
-                for (uint i = 0; i < inventory.size(); i++)
-                {
-                    FishingLog &fish = inventory.components[i];
-                    if (fish.lake_id == 2)
-                    { // TODO: unhardcode this
-                        ++fishSpeciesCount[fish.species_id];
-                    }
-                }
-                for (int row = 0; row < 6; row++)
-                {
-                    ImGui::TableNextRow();
-                    for (int column = 0; column < num_columns; column++)
-                    {
-                        // ImGui::TableSetColumnIndex(column);
-                        // // This commented out code is how to set the background of the cell
-                        // /*ImVec2 p = ImGui::GetCursorScreenPos();
-                        // ImGui::GetWindowDrawList()->AddImage((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + 104.f, p.y + 102.f), ImVec2(0, 0), ImVec2(1, 1));*/
-                        // ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(103.f, 102.f));
-                        int cell_count = row * num_columns + column;
-                        ImGui::TableSetColumnIndex(column);
-                        ImVec2 p = ImGui::GetCursorScreenPos();
-                        ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
-
-                        if (fishSpeciesCount.find(cell_count) == fishSpeciesCount.end())
-                        {
-                            // not found
-                            // ImGui::Image((void*)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], ImVec2(103.f, 102.f));
-                            ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::CHINOOK_SHADOW], ImVec2(item_size, item_size));
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip("???");
-                            }
-                        }
-                        else
-                        {
-                            // found
-                            FishSpecies species = id_to_fish_species.at(cell_count);
-                            // different species should have different textures
-                            ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)cell_count], ImVec2(item_size, item_size));
-
-                            if (ImGui::IsItemHovered())
-                            {
-                                ImGui::SetTooltip(species.name.c_str());
-                            }
-                        }
-                    }
-                }
-                ImGui::PopFont();
-                ImGui::EndTable();
-            }
+            drawFishLogTable("Lake 2 Fish", 2, num_columns, item_size);
             ImGui::EndTabItem();
         }
         ImGui::EndTabBar();
@@ -2490,12 +2549,62 @@ void RenderSystem::drawInventory()
     ImGui::End();
 }
 
+// One tab of the fishing log: a cell per species with how many were caught in the lake, in
+// any lake for lake_id 0. Only the rows in view are drawn.
+void RenderSystem::drawFishLogTable(const char* table_id, int lake_id, int num_columns, float item_size)
+{
+    if (!ImGui::BeginTable(table_id, num_columns, ImGuiTableFlags_Borders | ImGuiTableFlags_SizingFixedSame | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
+        return;
+    ImGui::PushFont(font_small);
+    int num_rows = std::max(6, (fish_texture_count + num_columns - 1) / num_columns);
+    ImGuiListClipper clipper;
+    clipper.Begin(num_rows);
+    while (clipper.Step())
+    {
+        for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
+        {
+            ImGui::TableNextRow();
+            for (int column = 0; column < num_columns; column++)
+            {
+                int cell_count = row * num_columns + column;
+                ImGui::TableSetColumnIndex(column);
+                ImVec2 p = ImGui::GetCursorScreenPos();
+                ImGui::GetWindowDrawList()->AddImage((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::ITEM_CELL], p, ImVec2(p.x + item_size, p.y + item_size), ImVec2(0, 0), ImVec2(1, 1));
+
+                int caught = lake_id == 0 ? fish_collection.caught(cell_count) : fish_collection.record(cell_count, lake_id).caught;
+                if (caught == 0)
+                {
+                    // not found
+                    ImGui::Image((void *)(intptr_t)texture_gl_handles[(int)TEXTURE_ASSET_ID::CHINOOK_SHADOW], ImVec2(item_size, item_size));
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("???");
+                    }
+                }
+                else
+                {
+                    // found
+                    // different species should have different textures
+                    ImGui::Image((void *)(intptr_t)fish_texture_gl_handles[(int)cell_count], ImVec2(item_size, item_size));
+
+                    if (ImGui::IsItemHovered())
+                    {
+                        ImGui::SetTooltip("%s (%d caught)", species_name(cell_count), caught);
+                    }
+                }
+            }
+        }
+    }
+    ImGui::PopFont();
+    ImGui::EndTable();
+}
+
 // draws the Shop UI
 void RenderSystem::drawShop()
 {
     Entity player = registry.players.entities[0];
     Entity fishingRod = registry.fishingRods.entities[0];
-    json shopkeep_dialogue = dialogue["shopkeeper"];
+    const json& shopkeep_dialogue = jsonChild(dialogue, "shopkeeper");
 
     drawMenu();
     drawMenuItems();
@@ -2517,9 +2626,9 @@ void RenderSystem::drawShop()
             const char* messages[] = {
                     "Durability +5",
                     "Attack     +5", };
-            const float durabilityIncrease[] = { 5.f, 0.f };
-            const int attackIncrease[] = { 0, 5 };
-            const int price[] = { 14, 16 };
+            const float durabilityIncrease[] = { ROD_DURABILITY_PER_UPGRADE, 0.f };
+            const int attackIncrease[] = { 0, ROD_ATTACK_PER_UPGRADE };
+            const int price[] = { ROD_DURABILITY_UPGRADE_PRICE, ROD_ATTACK_UPGRADE_PRICE };
             int numFishingRodOptions = sizeof(attackIncrease)/sizeof(attackIncrease[0]);
             for (int row = 0; row < numFishingRodOptions; row++)
             {
@@ -2529,8 +2638,7 @@ void RenderSystem::drawShop()
                 ImGui::TableNextRow(0, 100.f * scale_y);
                 ImGui::TableSetColumnIndex(0);
                 setDrawCursorScreenPos(ImVec2(10.f, 10.f));
-                std::string buyMessage(messages[row]);
-                ImGui::Text(buyMessage.c_str(), price[row]);
+                ImGui::TextUnformatted(messages[row]);
                 setDrawCursorScreenPos(ImVec2(10.f, 0.f));
                 ImGui::Text("%d gold", price[row]);
                 // Put button to the left of shop window (hard coded)
@@ -2549,11 +2657,8 @@ void RenderSystem::drawShop()
                     disable = attack.num_upgrades == attack.max_upgrade;
                 }
                 ImGui::BeginDisabled(disable);
-                std::string buttonName = "BUY##" + std::to_string(row);
-                if (disable) {
-                    buttonName = "MAX##" + std::to_string(row);
-                }
-                if (ImGui::Button(buttonName.c_str(), ImVec2(70.f * scale_x, 30.f * scale_y)))
+                const char* buttonName = ui_format("%s##%d", disable ? "MAX" : "BUY", row);
+                if (ImGui::Button(buttonName, ImVec2(70.f * scale_x, 30.f * scale_y)))
                 {
                     Wallet& wallet = registry.wallet.get(player);
                     if (wallet.gold < price[row])
@@ -2576,6 +2681,7 @@ void RenderSystem::drawShop()
                         if (row == 1) {
                             attack.num_upgrades++;
                         }
+                        save_journal.record(JournalRecord::rod_upgraded(wallet.gold, durability.max, durability.num_upgrades, attack.damage, attack.num_upgrades));
                     }
                 }
                 ImGui::EndDisabled();
@@ -2607,8 +2713,7 @@ void RenderSystem::drawShop()
                 ImGui::TableSetColumnIndex(0);
 
                 setDrawCursorScreenPos(ImVec2(10.f, 10.f));
-                std::string buyMessage = lure.description + std::string(" - 10 pack");
-                ImGui::TextUnformatted(buyMessage.c_str());
+                ImGui::Text("%s - %d pack", lure.description.c_str(), LURE_PACK_SIZE);
                 setDrawCursorScreenPos(ImVec2(10.f, 0.f));
                 ImGui::Text("%d gold", lure.price);
                 // Put button to the left of shop window (hard coded)
@@ -2616,8 +2721,7 @@ void RenderSystem::drawShop()
 
                 ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
 
-                std::string buttonName = "BUY##" + std::to_string(row);
-                if (ImGui::Button(buttonName.c_str(), ImVec2(70.f * scale_x, 30.f * scale_y)))
+                if (ImGui::Button(ui_format("BUY##%d", row), ImVec2(70.f * scale_x, 30.f * scale_y)))
                 {
                     Wallet& wallet = registry.wallet.get(player);
                     if (wallet.gold < lure.price)
@@ -2629,7 +2733,8 @@ void RenderSystem::drawShop()
                         shop_state = SHOP_STATE::BUY;
                         sound_system->playSound(sound_system->chaching);
                         wallet.gold -= lure.price;
-                        lure.numOwned += 10;
+                        lure.numOwned += LURE_PACK_SIZE;
+                        save_journal.record(JournalRecord::lure_bought(wallet.gold));
                     }
                 }
                 ImGui::PopStyleVar(3);
@@ -2642,35 +2747,47 @@ void RenderSystem::drawShop()
     {
         if (ImGui::BeginTable("Sellable", 1, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_PreciseWidths))
         {
-            auto &inventory = registry.fishInventory;
-            for (uint row = 0; row < inventory.size(); row++)
+            // a row per species owned, stacked, and only the rows in view are drawn
+            int* stacks = frame_arena.allocate_array<int>(fish_collection.species_count());
+            int num_stacks = fish_collection.owned_species(stacks);
+            ImGuiListClipper clipper;
+            clipper.Begin(num_stacks);
+            while (clipper.Step())
             {
-                Fish &fish = inventory.components[row];
-                Entity& fish_entity = inventory.entities[row];
-                FishSpecies species = id_to_fish_species.at(fish.species_id);
-                ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(10, 10));
-                ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 2.f);
-                ImGui::TableNextRow(0, 100.f * scale_y);
-                ImGui::TableSetColumnIndex(0);
-                setDrawCursorScreenPos(ImVec2(10.f, 10.f));
-                ImGui::Text("#%d. %s", row + 1, species.name.c_str());
-                setDrawCursorScreenPos(ImVec2(10.f, 0.f));
-                ImGui::Text("%s gold", std::to_string(species.price).c_str());
-                // Put button to the left of shop window (hard coded -- will need to adjust based on whats drawn)
-                setDrawCursorScreenPos(ImVec2(730.f, -40.f));
-
-                std::string buttonName = "SELL##" + std::to_string(row);
-                ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
-                if (ImGui::Button(buttonName.c_str(), ImVec2(70.f * scale_x, 30.f * scale_y)))
+                for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++)
                 {
-                    shop_state = SHOP_STATE::SELL;
-                    sound_system->playSound(sound_system->sell);
-                    // remove fish from inventory and add money to wallet B)
-                    registry.fishInventory.remove(fish_entity); // TODO: add money to wallet, remove
-                    Wallet& wallet = registry.wallet.get(player);
-                    wallet.gold += species.price;
+                    int species_id = stacks[row];
+                    int owned = fish_collection.owned(species_id);
+                    const FishSpecies& species = id_to_fish_species.at(species_id);
+                    ImGui::PushStyleVar(ImGuiStyleVar_CellPadding, ImVec2(10, 10));
+                    ImGui::PushStyleVar(ImGuiStyleVar_FrameBorderSize, 2.f);
+                    ImGui::TableNextRow(0, 100.f * scale_y);
+                    ImGui::TableSetColumnIndex(0);
+                    setDrawCursorScreenPos(ImVec2(10.f, 10.f));
+                    ImGui::Text("#%d. %s x%d", row + 1, species_name(species_id), owned);
+                    setDrawCursorScreenPos(ImVec2(10.f, 0.f));
+                    ImGui::Text("%d gold", species.price);
+                    // Put buttons to the left of shop window (hard coded -- will need to adjust based on whats drawn)
+                    setDrawCursorScreenPos(ImVec2(600.f, -40.f));
+
+                    ImGui::PushStyleVar(ImGuiStyleVar_FramePadding, ImVec2(0, 0));
+                    bool sell_all = ImGui::Button(ui_format("SELL ALL##%d", species_id), ImVec2(120.f * scale_x, 30.f * scale_y));
+                    ImGui::SameLine(0.f, 10.f * scale_x);
+                    bool sell_one = ImGui::Button(ui_format("SELL##%d", species_id), ImVec2(70.f * scale_x, 30.f * scale_y));
+                    if (sell_one || sell_all)
+                    {
+                        shop_state = SHOP_STATE::SELL;
+                        sound_system->playSound(sound_system->sell);
+                        // remove the fish from inventory and add money to wallet B)
+                        int sold = fish_collection.sell(species_id, sell_all ? owned : 1);
+                        if (sold > 0) {
+                            Wallet& wallet = registry.wallet.get(player);
+                            wallet.gold += species.price * sold;
+                            save_journal.record(JournalRecord::sold(species_id, wallet.gold, sold));
+                        }
+                    }
+                    ImGui::PopStyleVar(3);
                 }
-                ImGui::PopStyleVar(3);
             }
             ImGui::EndTable();
         }
@@ -2692,22 +2809,22 @@ void RenderSystem::drawShop()
     ImGui::Begin("Shop Text", NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoScrollbar);
     //ImGui::PushStyleColor(ImGuiCol_ChildBg, ImVec4(239.f / 255.f, 225.f / 255.f, 178.f / 255.f, 1.00f));
     ImGui::BeginChild("Shop Text", ImVec2(412.f * scale_x, 240.f * scale_y), true, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
-    std::string shop_text;
+    const char* shop_text = "";
     switch (shop_state) {
         case SHOP_STATE::WELCOME:
-            shop_text = shopkeep_dialogue.value("welcome", "error");
+            shop_text = jsonText(shopkeep_dialogue, "welcome", "error");
             break;
         case SHOP_STATE::BUY:
-            shop_text = shopkeep_dialogue.value("buy", "error");
+            shop_text = jsonText(shopkeep_dialogue, "buy", "error");
             break;
         case SHOP_STATE::SELL:
-            shop_text = shopkeep_dialogue.value("sell", "error");
+            shop_text = jsonText(shopkeep_dialogue, "sell", "error");
             break;
         case SHOP_STATE::BUY_NO_MONEY:
-            shop_text = shopkeep_dialogue.value("broke", "error");
+            shop_text = jsonText(shopkeep_dialogue, "broke", "error");
             break;
     }
-    ImGui::TextWrapped(shop_text.c_str());
+    ImGui::TextWrapped("%s", shop_text);
     ImGui::EndChild();
     //ImGui::PopStyleColor();
     ImGui::End();
@@ -3054,6 +3171,10 @@ void RenderSystem::createSaveButtons(const char* id, const char* button_id, cons
         } else if (game_state == GAME_STATE_ID::LOAD_SAVE) {
             *current_game_state = GAME_STATE_ID::LOAD_SAVE;
         } else if (game_state == GAME_STATE_ID::DELETE_SAVE_DONE) {
+            // once, here: a save still being written would bring the deleted one back
+            save_service.flush();
+            save_slots.remove(save_slots.selected());
+            save_journal.detach(save_slots.selected());
             *current_game_state = GAME_STATE_ID::DELETE_SAVE_DONE;
         } else if (game_state == GAME_STATE_ID::TELEPORT_1_DONE) {
             *current_game_state = GAME_STATE_ID::TELEPORT_1_DONE;
@@ -3209,16 +3330,16 @@ void RenderSystem::drawDialogueCutscene() {
     // should only be one dialogue at a time
     Dialogue& dialogue_request = registry.dialogues.components[0];
     Entity& player = registry.dialogues.entities[0];
-    json dialogue_info = dialogue[dialogue_request.cutscene_id.c_str()];
-    json conversation = dialogue_info["conversation"];
-    json popup_info = dialogue_info["popup"];
+    const json& dialogue_info = jsonChild(dialogue, dialogue_request.cutscene_id.c_str());
+    const json& conversation = jsonChild(dialogue_info, "conversation");
+    const json& popup_info = jsonChild(dialogue_info, "popup");
     int num_lines = dialogue_info.value("num_lines", 0);
 
     TEXTURE_ASSET_ID mc_texture = TEXTURE_ASSET_ID::MC_DIALOGUE;
     TEXTURE_ASSET_ID ally_texture = (TEXTURE_ASSET_ID) dialogue_info.value("texture_ally", 0);
     char text_id[10];
     sprintf(text_id, "line_%d", dialogue_request.current_line);
-    json text_info = conversation[text_id];
+    const json& text_info = jsonChild(conversation, text_id);
 
     TEXTURE_ASSET_ID bg_texture = (TEXTURE_ASSET_ID)text_info.value("background", 0);
 
@@ -3226,7 +3347,8 @@ void RenderSystem::drawDialogueCutscene() {
 
     float mc_active;
     float ally_active;
-    if (text_info.value(name, "Error") == "Jonah" || text_info.value(name, "Error") == "???") {
+    const char* speaker = jsonText(text_info, name, "Error");
+    if (strcmp(speaker, "Jonah") == 0 || strcmp(speaker, "???") == 0) {
         mc_active = 0.f;
         ally_active = 0.4f;
     }
@@ -3250,18 +3372,20 @@ void RenderSystem::drawDialogueCutscene() {
     ImGui::PushStyleVar(ImGuiStyleVar_WindowBorderSize, 5.0f);
     ImGui::SetNextWindowPos(ImVec2(0.f, (window_height_px - 300.f) * scale_y));
     ImGui::SetNextWindowSize(ImVec2(window_width_px * scale_x, 300.0f * scale_y));
-    ImGui::Begin(text_info.value(name, "ERROR").c_str(), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoCollapse);
+    ImGui::Begin(jsonText(text_info, name, "ERROR"), NULL, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoScrollbar | ImGuiWindowFlags_NoBringToFrontOnFocus | ImGuiWindowFlags_NoCollapse);
     setDrawCursorScreenPos(ImVec2(10.f, 10.f));
-    ImGui::TextWrapped(text_info.value(text, "error").c_str());
+    ImGui::TextWrapped("%s", jsonText(text_info, text, "error"));
 
     ImGui::SetCursorScreenPos(ImVec2((window_width_px - 160)*scale_x, (window_height_px - 80)*scale_y));
     if (dialogue_request.current_line == num_lines - 1) {
         if (ImGui::Button("End", ImVec2(100.f * scale_x, 40.f * scale_y))) {
             if (registry.dialogues.get(player).cutscene_id.compare(std::string("ally_1_recruit")) == 0) {
                 registry.players.get(player).ally1_recruited = true;
+                save_journal.record(JournalRecord::recruited(1));
             }
             else if (registry.dialogues.get(player).cutscene_id.compare(std::string("ally_2_recruit")) == 0) {
                 registry.players.get(player).ally2_recruited = true;
+                save_journal.record(JournalRecord::recruited(2));
             }
             registry.dialogues.remove(player);
             if (!popup_info.is_null()) {
@@ -3303,10 +3427,18 @@ void RenderSystem::drawStartMenu() {
     ImGui::PushStyleVar(ImGuiStyleVar_ChildBorderSize, 6.0f);
     ImGui::SetNextWindowPos(ImVec2((window_width_px/2 - 150.f) * scale_x, (window_height_px/2 + 160.f) * scale_y));
     ImGui::BeginChild("Options", ImVec2(300.0f * scale_x, 220.0f * scale_y), true, ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse);
-    std::ifstream is("../savedata.json", std::ios::ate);
+    // from the save index, the saves themselves aren't touched
+    int recent_slot = save_slots.most_recent();
+    bool has_save = recent_slot >= 0;
 
     setDrawCursorScreenPos(ImVec2(50.f, 35.f));
     if (ImGui::Button("New Game", ImVec2(200.f * scale_x, 40.f * scale_y))) {
+        // a new game saves into the first empty slot, unless the player picks another
+        for (int slot = SaveSlots::SLOT_COUNT - 1; slot >= 0; slot--) {
+            if (!save_slots.used(slot))
+                save_slots.select(slot);
+        }
+        save_journal.start_new_game(save_slots.selected());
         Dialogue& dialogue = registry.dialogues.emplace(player);
         dialogue.cutscene_id = "introduction";
         *current_game_state = GAME_STATE_ID::CUTSCENE;
@@ -3314,12 +3446,13 @@ void RenderSystem::drawStartMenu() {
     }
 
     setDrawCursorScreenPos(ImVec2(50.f, 10.f));
-    ImGui::BeginDisabled(is.tellg() == 0);
+    ImGui::BeginDisabled(!has_save);
     if (ImGui::Button("Continue", ImVec2(200.f * scale_x, 40.f * scale_y))) {
-        if (is.tellg() == 0) { // check if save data exists
+        if (!has_save) { // check if save data exists
             *current_game_state = GAME_STATE_ID::LOAD_FAIL;
         }
         else {
+            save_slots.select(recent_slot);
             should_restart_game = true;
         }
     }
@@ -8,6 +8,10 @@
 #include "tiny_ecs.hpp"
 #include "battle_system.hpp"
 #include "sound_system.hpp"
+#include "render_snapshot.hpp"
+#include "rng.hpp"
+#include "save_slots.hpp"
+#include "save_service.hpp"
 
 #include "../imgui/imgui.h"
 #include <../nlohmann/json.hpp>
@@ -217,6 +221,12 @@ public:
     // Draw all entities
     void draw();
 
+    // Writes the last frame drawn into the headless framebuffer as a binary PPM
+    bool saveScreenshot(const std::string& path);
+    // Full save to the slot of the save journal, without the save screen, when
+    // save_journal.needs_full_save()
+    void autosave();
+
     mat3 createProjectionMatrix();
     //mat3 createFixedProjectionMatrix();
 
@@ -226,15 +236,36 @@ public:
     float scale_x;
     float scale_y;
 
+    // How far the frame is between the last two simulation steps, see FixedTimestep
+    float interpolation_alpha = 1.f;
+
     std::vector<Particle> particles;
 
 private:
+    // moves the bubbles of the start menu
+    RngStream menu_rng;
+
+    // Copies what is saved and hands it to the save service, save_status follows it
     void saveData();
+    // Copies what is saved to the slot and hands it to the save service
+    void writeSave(int slot, SaveService::Callback done);
+    enum class SaveStatus { IDLE, SAVING, DONE };
+    SaveStatus save_status = SaveStatus::IDLE;
+    // Downscales the world pass of this frame into a SaveSlotInfo thumbnail
+    void captureThumbnail(std::vector<unsigned char>& pixels);
+    // Picks the slot of save_slots that the save, load or delete screen acts on
+    void drawSaveSlots(bool only_used);
+    // the thumbnails of save_slots, uploaded again when its revision changes
+    std::array<GLuint, SaveSlots::SLOT_COUNT> slot_thumbnails = {};
+    uint64_t slot_thumbnails_revision = UINT64_MAX;
+    // thread_allocations() when the ImGui frame started, see RenderStats::ui_allocations
+    uint64_t ui_allocations_at_new_frame = 0;
     //Dear ImGui functions
     void createMainUIButtonWindow(GAME_STATE_ID id, const ImVec2& position);
     void drawMenuItems();
     void drawMenu();
     void drawInventory();
+    void drawFishLogTable(const char* table_id, int lake_id, int num_columns, float item_size);
     void drawShop();
     void drawParty();
     void drawMap();
@@ -253,9 +284,13 @@ private:
     void drawDialogueCutscene();
     void drawStartMenu();
 	// Internal drawing functions for each entity type
-	void drawTexturedMesh(Entity entity, const mat3& projection);
+	void drawTexturedMesh(const RenderSnapshot::Item& item, const mat3& projection);
 	void drawBattle();
 	void drawToScreen();
+	void renderImGui();
+	// Size of what is drawn to, the window framebuffer or the fixed headless resolution
+	void getDrawableSize(int& w, int& h) const;
+	void initHeadlessFramebuffer();
 	void createSkillsTable();
 	void createBattleLog();
 	void createCharacterPortrait(ImVec2 position, int index);
@@ -265,7 +300,7 @@ private:
         std::array<GLuint, texture_count>& texture_gl_handles,
         std::array<ivec2, texture_count>& texture_dimension);
 	void drawOnMenu();
-	void drawSpriteAnime(int frame, int num_rows, int num_columns, TEXTURE_ASSET_ID texture_asset_id, vec2 position, vec2 scale, float darken = 0.f, bool use_screen_matrix = true);
+	void drawSpriteAnime(int frame, int num_rows, int num_columns, TEXTURE_ASSET_ID texture_asset_id, vec2 position, vec2 scale, float darken = 0.f, bool use_screen_matrix = true, bool light_up = false);
     void playEnemyAnime(BattleSystem::AnimeEnum i);
     void playEffect(BattleSystem::AnimeEnum i);
     void drawMeshEffect(GEOMETRY_BUFFER_ID geo_id, EFFECT_ASSET_ID eff_id, vec4 c, vec2 pos, float angle, vec2 scale);
@@ -275,11 +310,14 @@ private:
     void drawPortraitsAnime(float xpos, TEXTURE_ASSET_ID asset_id);
     void drawDmgText(const char* text, ImVec2 position, ImU32 textColor);
 
-    std::vector<RenderRequestsNonEntity> renderRequestsNonEntity;
+    // effects of the enemy's attacks, one per kind at most
+    FixedVector<RenderRequestsNonEntity, 4> renderRequestsNonEntity;
 
     // Window handle
     GLFWwindow* window;
 
+    // camera of the render snapshot blended with interpolation_alpha, set at the start of draw()
+    Transform interpolated_view;
 
     // Current game state
     GAME_STATE_ID* current_game_state;
@@ -289,6 +327,9 @@ private:
     GLuint frame_buffer;
     GLuint off_screen_render_buffer_color;
     GLuint off_screen_render_buffer_depth;
+    // Stands in for the window's default framebuffer in headless mode, 0 otherwise
+    GLuint present_frame_buffer = 0;
+    GLuint present_render_buffer_color = 0;
 
     Entity screen_state_entity;
     BattleSystem* battle_system;
@@ -5,6 +5,9 @@
 #include <fstream>
 
 #include "../ext/stb_image/stb_image.h"
+#include "startup_profiler.hpp"
+#include "gpu_profiler.hpp"
+#include "launch_options.hpp"
 
 // This creates circular header inclusion, that is quite bad.
 #include "tiny_ecs_registry.hpp"
@@ -80,10 +83,11 @@ std::vector<TexturedVertex> createLakeMesh()
     float amps[N];
     float phases[N];
 
+    RngStream rng = rng_service.stream("lake_mesh");
     for (int i = 0; i < N; ++i)
     {
-        amps[i] = float(rand() % 300) / 100.f; // Random amplitude between 0 and 1
-        phases[i] = float(rand() % 630) / 100.f; // Random phase between 0 and 2π
+        amps[i] = float(rng.below(300)) / 100.f; // Random amplitude between 0 and 1
+        phases[i] = float(rng.below(630)) / 100.f; // Random phase between 0 and 2π
     }
 
     for (int i = 0; i < numPoints; ++i)
@@ -162,15 +166,22 @@ bool RenderSystem::init(GLFWwindow* window_arg, GAME_STATE_ID* game_state_arg, B
 	this->current_game_state = game_state_arg;
 	this->sound_system = sound_system_arg;
 	this->battle_system = battle_system;
+	menu_rng = rng_service.stream("menu");
 	
 	for (int i = 0; i < 100; ++i) {
 		particles.push_back(Particle());
 	}
 	glfwMakeContextCurrent(window);
-	glfwSwapInterval(1); // vsync
+	// vsync, except when headless where frames should go as fast as they can be drawn
+	glfwSwapInterval(launch_options.headless ? 0 : 1);
 
 	int device_width, device_height;
-	glfwGetWindowSize(window_arg, &device_width, &device_height);
+	if (launch_options.headless) {
+		device_width = launch_options.headless_width;
+		device_height = launch_options.headless_height;
+	}
+	else
+		glfwGetWindowSize(window_arg, &device_width, &device_height);
 	scale_x = ((float)device_width / (float)window_width_px);
 	scale_y = ((float)device_height / (float)window_height_px);
 
@@ -178,6 +189,9 @@ bool RenderSystem::init(GLFWwindow* window_arg, GAME_STATE_ID* game_state_arg, B
 	const int is_fine = gl3w_init();
 	assert(is_fine == 0);
 
+	// timer queries for the GPU side of the frame profiler
+	gpu_profiler.init();
+
 	// Create a frame buffer
 	frame_buffer = 0;
 	glGenFramebuffers(1, &frame_buffer);
@@ -187,8 +201,8 @@ bool RenderSystem::init(GLFWwindow* window_arg, GAME_STATE_ID* game_state_arg, B
 	// For some high DPI displays (ex. Retina Display on Macbooks)
 	// https://stackoverflow.com/questions/36672935/why-retina-screen-coordinate-value-is-twice-the-value-of-pixel-value
 	int frame_buffer_width_px, frame_buffer_height_px;
-	glfwGetFramebufferSize(window, &frame_buffer_width_px, &frame_buffer_height_px);  // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
-	if (frame_buffer_width_px != window_width_px)
+	getDrawableSize(frame_buffer_width_px, frame_buffer_height_px);
+	if (!launch_options.headless && frame_buffer_width_px != window_width_px)
 	{
 		printf("WARNING: retina display! https://stackoverflow.com/questions/36672935/why-retina-screen-coordinate-value-is-twice-the-value-of-pixel-value\n");
 		printf("glfwGetFramebufferSize = %d,%d\n", frame_buffer_width_px, frame_buffer_height_px);
@@ -208,10 +222,22 @@ bool RenderSystem::init(GLFWwindow* window_arg, GAME_STATE_ID* game_state_arg, B
 	glBindVertexArray(vao);
 	gl_has_errors();
 
-	initScreenTexture();
-    initializeGlTextures();
-	initializeGlEffects();
-	initializeGlGeometryBuffers();
+	{
+		StartupScope scope("initScreenTexture");
+		initScreenTexture();
+	}
+	{
+		StartupScope scope("initializeGlTextures");
+		initializeGlTextures();
+	}
+	{
+		StartupScope scope("initializeGlEffects");
+		initializeGlEffects();
+	}
+	{
+		StartupScope scope("initializeGlGeometryBuffers");
+		initializeGlGeometryBuffers();
+	}
 
 	return true;
 }
@@ -231,8 +257,10 @@ void RenderSystem::initializeGlTexturesFromPaths(
 
 		ivec2& dimensions = texture_dimensions[i];
 
+		auto decode_start = StartupProfiler::Clock::now();
 		stbi_uc* data;
 		data = stbi_load(path.c_str(), &dimensions.x, &dimensions.y, NULL, 4);
+		double decode_ms = StartupProfiler::ms_since(decode_start);
 
 		if (data == NULL)
 		{
@@ -240,12 +268,14 @@ void RenderSystem::initializeGlTexturesFromPaths(
 			fprintf(stderr, "%s", message.c_str());
 			assert(false);
 		}
+		auto upload_start = StartupProfiler::Clock::now();
 		glBindTexture(GL_TEXTURE_2D, texture_gl_handles[i]);
 		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, dimensions.x, dimensions.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		gl_has_errors();
 		stbi_image_free(data);
+		startup_profiler.record_asset(path, decode_ms, StartupProfiler::ms_since(upload_start));
     }
 	gl_has_errors();
 };
@@ -455,6 +485,7 @@ RenderSystem::~RenderSystem()
 	glDeleteTextures((GLsizei)fish_texture_gl_handles.size(), fish_texture_gl_handles.data());
 	glDeleteTextures(1, &off_screen_render_buffer_color);
 	glDeleteRenderbuffers(1, &off_screen_render_buffer_depth);
+	glDeleteTextures((GLsizei)slot_thumbnails.size(), slot_thumbnails.data());
 	gl_has_errors();
 
 	for(uint i = 0; i < effect_count; i++) {
@@ -462,6 +493,11 @@ RenderSystem::~RenderSystem()
 	}
 	// delete allocated resources
 	glDeleteFramebuffers(1, &frame_buffer);
+	if (present_frame_buffer != 0) {
+		glDeleteFramebuffers(1, &present_frame_buffer);
+		glDeleteRenderbuffers(1, &present_render_buffer_color);
+	}
+	gpu_profiler.destroy();
 	gl_has_errors();
 
 	// remove all entities created by the render system
@@ -475,7 +511,7 @@ bool RenderSystem::initScreenTexture()
 	registry.screenStates.emplace(screen_state_entity);
 
 	int framebuffer_width, framebuffer_height;
-	glfwGetFramebufferSize(const_cast<GLFWwindow*>(window), &framebuffer_width, &framebuffer_height);  // Note, this will be 2x the resolution given to glfwCreateWindow on retina displays
+	getDrawableSize(framebuffer_width, framebuffer_height);
 
 	glGenTextures(1, &off_screen_render_buffer_color);
 	glBindTexture(GL_TEXTURE_2D, off_screen_render_buffer_color);
@@ -493,9 +529,31 @@ bool RenderSystem::initScreenTexture()
 
 	assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
 
+	if (launch_options.headless)
+		initHeadlessFramebuffer();
+
 	return true;
 }
 
+// The default framebuffer of a hidden window may not keep its pixels, so headless frames
+// are composited into a framebuffer of their own that screenshots are read back from
+void RenderSystem::initHeadlessFramebuffer()
+{
+	int framebuffer_width, framebuffer_height;
+	getDrawableSize(framebuffer_width, framebuffer_height);
+
+	glGenFramebuffers(1, &present_frame_buffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, present_frame_buffer);
+	glGenRenderbuffers(1, &present_render_buffer_color);
+	glBindRenderbuffer(GL_RENDERBUFFER, present_render_buffer_color);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, framebuffer_width, framebuffer_height);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, present_render_buffer_color);
+	gl_has_errors();
+
+	assert(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+}
+
 void RenderSystem::initFonts() {
 	// initialize fonts
 	ImGuiIO& io = ImGui::GetIO();
@@ -508,6 +566,7 @@ void RenderSystem::initFonts() {
 
 	//json test
 	std::ifstream f(data_path() + "/dialogue.json");
+	MemoryScope memory_scope(MemoryTag::DIALOGUE);
 	dialogue = json::parse(f);
 }
 
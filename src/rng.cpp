@@ -0,0 +1,36 @@
+// Header
+#include "rng.hpp"
+
+RngService rng_service;
+
+RngStream::RngStream(uint64_t seed, uint64_t gamma)
+	: seed(seed)
+	// an even gamma would only ever reach half of the numbers
+	, gamma(gamma | 1)
+{
+}
+
+uint64_t RngStream::mix(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+void RngService::seed(uint64_t master_seed)
+{
+	master = master_seed;
+}
+
+RngStream RngService::stream(const char* name, uint64_t index) const
+{
+	// FNV-1a of the name
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (const char* c = name; *c != '\0'; c++) {
+		hash ^= (unsigned char)*c;
+		hash *= 0x100000001b3ull;
+	}
+	uint64_t key = RngStream::mix(master ^ RngStream::mix(hash + index * 0x9e3779b97f4a7c15ull));
+	// streams also step by different gammas, so they don't just run at an offset of each other
+	return RngStream(key, RngStream::mix(key + 0x9e3779b97f4a7c15ull));
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <limits>
+
+// Counter-based random number stream (SplitMix64). The n-th number is a hash of
+// seed + n * gamma, so a stream is just three integers: it's cheap to create, can jump to
+// any position and never depends on what other streams drew. Works with the <random>
+// distributions.
+class RngStream
+{
+public:
+	typedef uint64_t result_type;
+
+	RngStream() = default;
+	RngStream(uint64_t seed, uint64_t gamma);
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()()
+	{
+		counter++;
+		return mix(seed + counter * gamma);
+	}
+
+	// Numbers drawn so far, seek() goes back or forward to a position
+	uint64_t position() const { return counter; }
+	void seek(uint64_t position) { counter = position; }
+
+	// in [0, 1)
+	float uniform() { return (float)((*this)() >> 40) * (1.f / 16777216.f); }
+	// in [0, n), n > 0
+	int below(int n) { return (int)((*this)() % (uint64_t)n); }
+
+	static uint64_t mix(uint64_t z);
+
+private:
+	uint64_t seed = 0;
+	uint64_t gamma = 0x9e3779b97f4a7c15ull;
+	uint64_t counter = 0;
+};
+
+// Hands out the random streams of the game. Every stream is derived from one master seed
+// and its name (plus an optional index for streams split over jobs), so a system always
+// gets the same numbers for the same seed no matter what the other systems draw or in
+// which order they are created.
+//
+// The master seed comes from std::random_device unless --seed=N is given, main() prints it
+// so any run can be repeated.
+class RngService
+{
+public:
+	void seed(uint64_t master_seed);
+	uint64_t master_seed() const { return master; }
+
+	RngStream stream(const char* name, uint64_t index = 0) const;
+
+private:
+	uint64_t master = 0;
+};
+
+extern RngService rng_service;
@@ -0,0 +1,191 @@
+// Header
+#include "save_data.hpp"
+
+// stlib
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <../cereal/archives/json.hpp>
+#include <../cereal/archives/portable_binary.hpp>
+#include <../cereal/types/deque.hpp>
+#include <../cereal/types/vector.hpp>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char MAGIC[8] = { 'L', 'O', 'T', 'L', 'S', 'A', 'V', 'E' };
+
+	// written to by the thread of the save service
+	std::atomic<uint64_t> generation(0);
+}
+
+bool file_has_data(const std::string& path)
+{
+	std::ifstream is(path, std::ios::binary | std::ios::ate);
+	return is.is_open() && is.tellg() > 0;
+}
+
+// Writes the bytes to path.tmp, flushes them to the disk and renames the file over path, so
+// path always holds either the old or the new file, even if the game or the computer goes
+// down in between
+bool write_file_atomic(const std::string& path, const std::string& bytes)
+{
+	std::string temp_path = path + ".tmp";
+	FILE* file = fopen(temp_path.c_str(), "wb");
+	if (file == nullptr) {
+		fprintf(stderr, "Could not open %s to write\n", temp_path.c_str());
+		return false;
+	}
+	bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() && fflush(file) == 0;
+#ifdef _WIN32
+	ok = ok && _commit(_fileno(file)) == 0;
+#else
+	ok = ok && fsync(fileno(file)) == 0;
+#endif
+	ok = fclose(file) == 0 && ok;
+	if (!ok) {
+		fprintf(stderr, "Could not write %s\n", temp_path.c_str());
+		std::remove(temp_path.c_str());
+		return false;
+	}
+#ifdef _WIN32
+	ok = MoveFileExA(temp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+	ok = rename(temp_path.c_str(), path.c_str()) == 0;
+	if (ok) {
+		// the rename itself is only safe once the directory is on the disk too
+		size_t slash = path.find_last_of('/');
+		std::string directory = slash == std::string::npos ? "." : path.substr(0, slash + 1);
+		int fd = open(directory.c_str(), O_RDONLY);
+		if (fd >= 0) {
+			fsync(fd);
+			close(fd);
+		}
+	}
+#endif
+	if (!ok) {
+		fprintf(stderr, "Could not replace %s with the new file\n", path.c_str());
+		std::remove(temp_path.c_str());
+	}
+	return ok;
+}
+
+bool write_save(const std::string& path, const SaveData& data)
+{
+	std::ostringstream os(std::ios::binary);
+	os.write(MAGIC, sizeof(MAGIC));
+	unsigned char version[4];
+	for (int i = 0; i < 4; i++)
+		version[i] = (unsigned char)(SaveData::VERSION >> (8 * i));
+	os.write((const char*)version, sizeof(version));
+	{
+		cereal::PortableBinaryOutputArchive archive(os);
+		archive(data);
+	}
+	if (!write_file_atomic(path, os.str()))
+		return false;
+	generation++;
+	return true;
+}
+
+bool write_save_json(const std::string& path, const SaveData& data)
+{
+	std::ostringstream os;
+	{
+		// the fields go straight into the root object like the saves of older builds, cereal
+		// casts the const away for serialize() the same way
+		cereal::JSONOutputArchive archive(os);
+		uint32_t schema_version = SaveData::VERSION;
+		archive(CEREAL_NVP(schema_version));
+		const_cast<SaveData&>(data).serialize(archive);
+	}
+	if (!write_file_atomic(path, os.str()))
+		return false;
+	generation++;
+	return true;
+}
+
+bool read_save(const std::string& path, SaveData& data)
+{
+	std::ifstream is(path, std::ios::binary);
+	if (!is)
+		return false;
+	char magic[sizeof(MAGIC)] = {};
+	is.read(magic, sizeof(magic));
+	try {
+		if (is && memcmp(magic, MAGIC, sizeof(MAGIC)) == 0) {
+			unsigned char version[4] = {};
+			is.read((char*)version, sizeof(version));
+			data.schema_version = version[0] | (version[1] << 8) | (version[2] << 16) | ((uint32_t)version[3] << 24);
+			if (!is || data.schema_version == 0 || data.schema_version > SaveData::VERSION) {
+				fprintf(stderr, "%s is a save of version %u, this build reads up to version %u\n", path.c_str(), data.schema_version, SaveData::VERSION);
+				return false;
+			}
+			cereal::PortableBinaryInputArchive archive(is);
+			archive(data);
+		}
+		else {
+			is.clear();
+			is.seekg(0);
+			cereal::JSONInputArchive archive(is);
+			// JSON saves of older builds don't have a version
+			try {
+				archive(cereal::make_nvp("schema_version", data.schema_version));
+			}
+			catch (const cereal::Exception&) {
+				data.schema_version = 1;
+			}
+			data.serialize(archive);
+		}
+	}
+	catch (const std::exception& e) {
+		fprintf(stderr, "Could not read the save %s: %s\n", path.c_str(), e.what());
+		return false;
+	}
+	if (data.schema_version < 2) {
+		data.collection.load_legacy(data.fishes, data.fishlog);
+		data.fishes.clear();
+		data.fishlog.clear();
+	}
+	return true;
+}
+
+bool load_save(const std::string& path, const std::string& json_path, SaveData& data)
+{
+	if (file_has_data(path))
+		return read_save(path, data);
+	return read_save(json_path, data);
+}
+
+void delete_save(const std::string& path, const std::string& json_path)
+{
+	std::remove(path.c_str());
+	std::remove(json_path.c_str());
+	generation++;
+}
+
+uint64_t save_generation()
+{
+	return generation;
+}
+
+void bump_save_generation()
+{
+	generation++;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// internal
+#include "components.hpp"
+#include "fish_collection.hpp"
+
+// Everything a save file holds. RenderSystem::saveData() fills it from the registry and
+// WorldSystem::restart_game() sets the game up from it.
+//
+// Saves are written in a binary format: the magic "LOTLSAVE", the schema version as a
+// little endian uint32, then the fields through cereal's PortableBinaryArchive. With
+// --save-json the same fields are also exported to SAVE_JSON_PATH, which is also where
+// saves of older builds were written, and which is loaded when there is no binary save.
+//
+// Version 2 replaced the list of every fish owned and caught (fishes, fishlog) with the
+// counts of the FishCollection. read_save() turns the lists of older saves into counts.
+// Version 3 added journal_id, the journal of the slot (SaveJournal) is replayed on top of
+// the save it names.
+struct SaveData
+{
+	// Schema of the binary format, bump it when fields are added and branch on
+	// schema_version in serialize() to keep loading the older ones
+	static const uint32_t VERSION = 3;
+	// schema of the file this was loaded from
+	uint32_t schema_version = VERSION;
+
+	float posX = 0.f;
+	float posY = 0.f;
+	int lake_id = 1;
+	bool ally1_recruited = false;
+	bool ally2_recruited = false;
+	bool shiny_tutorial = false;
+	bool battle_tutorial_complete = false;
+	bool lake1_boss_defeated = false;
+	int num_fish_caught_lake1 = 0;
+	int num_fish_caught_lake2 = 0;
+	bool basic_tutorial_complete = false;
+	bool fishing_tutorial_complete = false;
+	bool lake2_entered = false;
+	float cameraX = 0.f;
+	float cameraY = 0.f;
+	int gold = 0;
+	float dur_max = 0.f;
+	float dur_curr = 0.f;
+	float dur_upgrades = 0.f;
+	int attack = 0;
+	float attack_upgrades = 0.f;
+	int defense = 0;
+	FishCollection collection;
+	// only in saves of version 1
+	std::vector<Fish> fishes;
+	std::vector<FishingLog> fishlog;
+	bool currently_lake_1 = true;
+	bool second_lake_unlocked = true;
+	// the journal written after this save, see SaveJournal; 0 in older saves, which have none
+	uint64_t journal_id = 0;
+
+	template<class Archive>
+	void serialize(Archive & archive)
+	{
+		archive(CEREAL_NVP(posX), CEREAL_NVP(posY));
+		archive(CEREAL_NVP(lake_id), CEREAL_NVP(ally1_recruited), CEREAL_NVP(ally2_recruited), CEREAL_NVP(shiny_tutorial), CEREAL_NVP(battle_tutorial_complete), CEREAL_NVP(lake1_boss_defeated),
+			CEREAL_NVP(num_fish_caught_lake1), CEREAL_NVP(num_fish_caught_lake2), CEREAL_NVP(basic_tutorial_complete), CEREAL_NVP(fishing_tutorial_complete), CEREAL_NVP(lake2_entered));
+		archive(CEREAL_NVP(cameraX), CEREAL_NVP(cameraY));
+		archive(CEREAL_NVP(gold));
+		archive(CEREAL_NVP(dur_max), CEREAL_NVP(dur_curr), CEREAL_NVP(dur_upgrades), CEREAL_NVP(attack), CEREAL_NVP(attack_upgrades), CEREAL_NVP(defense));
+		if (schema_version >= 2) {
+			archive(CEREAL_NVP(collection));
+		}
+		else {
+			archive(CEREAL_NVP(fishes));
+			archive(CEREAL_NVP(fishlog));
+		}
+		archive(CEREAL_NVP(currently_lake_1));
+		archive(CEREAL_NVP(second_lake_unlocked));
+		if (schema_version >= 3) {
+			archive(CEREAL_NVP(journal_id));
+		}
+	}
+};
+
+// the first save slot, the others are numbered (see SaveSlots)
+const std::string SAVE_PATH = "../savedata.sav";
+const std::string SAVE_JSON_PATH = "../savedata.json";
+
+// Binary save, false (after printing why) if it couldn't be written. The file is replaced
+// atomically, a crash while saving leaves the previous save behind.
+bool write_save(const std::string& path, const SaveData& data);
+// Same fields as JSON, for debugging and editing saves by hand
+bool write_save_json(const std::string& path, const SaveData& data);
+// Reads a binary save, or a JSON one if the file doesn't start with the magic
+bool read_save(const std::string& path, SaveData& data);
+
+// The binary save if there is one, the JSON one otherwise
+bool load_save(const std::string& path, const std::string& json_path, SaveData& data);
+void delete_save(const std::string& path, const std::string& json_path);
+
+// path is replaced with the bytes all at once, a crash while writing leaves the old file
+bool write_file_atomic(const std::string& path, const std::string& bytes);
+bool file_has_data(const std::string& path);
+// Goes up whenever this process writes or deletes a save, so what was built from a save can
+// tell if it still matches the one on the disk
+uint64_t save_generation();
+// For writes to the other files loading a save reads, like its journal
+void bump_save_generation();
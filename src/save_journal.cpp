@@ -0,0 +1,377 @@
+// Header
+#include "save_journal.hpp"
+
+// stlib
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+// internal
+#include "game_clock.hpp"
+#include "save_service.hpp"
+#include "save_slots.hpp"
+
+SaveJournal save_journal;
+
+namespace
+{
+	const char JOURNAL_MAGIC[8] = { 'L', 'O', 'T', 'L', 'J', 'R', 'N', 'L' };
+	const uint32_t JOURNAL_VERSION = 1;
+	const size_t HEADER_SIZE = sizeof(JOURNAL_MAGIC) + 4 + 8;
+	const size_t RECORD_SIZE = 1 + 3 * 4 + 3 * 4 + 8;
+	const size_t BATCH_HEADER_SIZE = 4 + 4;
+	// how long a record waits in memory before it goes to the disk
+	const double FLUSH_INTERVAL_S = 2.0;
+	// wait before trying a full save again after one failed
+	const double RETRY_INTERVAL_S = 30.0;
+
+	void put(std::string& bytes, uint64_t value, int size)
+	{
+		for (int i = 0; i < size; i++)
+			bytes.push_back((char)(value >> (8 * i)));
+	}
+
+	uint64_t get(const char* bytes, int size)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < size; i++)
+			value |= (uint64_t)(unsigned char)bytes[i] << (8 * i);
+		return value;
+	}
+
+	void put_float(std::string& bytes, float value)
+	{
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		put(bytes, bits, 4);
+	}
+
+	float get_float(const char* bytes)
+	{
+		uint32_t bits = (uint32_t)get(bytes, 4);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	uint32_t fnv1a(const char* bytes, size_t size)
+	{
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < size; i++) {
+			hash ^= (unsigned char)bytes[i];
+			hash *= 16777619u;
+		}
+		return hash;
+	}
+
+	std::string header(uint64_t journal_id)
+	{
+		std::string bytes(JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+		put(bytes, JOURNAL_VERSION, 4);
+		put(bytes, journal_id, 8);
+		return bytes;
+	}
+
+	bool read_file(const std::string& path, std::string& bytes)
+	{
+		std::ifstream is(path, std::ios::binary);
+		if (!is.is_open())
+			return false;
+		bytes.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+		return true;
+	}
+
+	// Walks the batches of the journal of the save with the journal_id. Returns the size of
+	// the part that is intact, 0 if the journal belongs to another save.
+	size_t read_batches(const std::string& bytes, uint64_t journal_id, std::vector<JournalRecord>* records)
+	{
+		if (bytes.size() < HEADER_SIZE || bytes.compare(0, HEADER_SIZE, header(journal_id)) != 0)
+			return 0;
+		size_t offset = HEADER_SIZE;
+		while (offset + BATCH_HEADER_SIZE <= bytes.size()) {
+			const char* batch = bytes.data() + offset;
+			size_t size = (size_t)get(batch, 4);
+			if (size % RECORD_SIZE != 0 || size > bytes.size() - offset - BATCH_HEADER_SIZE)
+				break;
+			const char* payload = batch + BATCH_HEADER_SIZE;
+			if (fnv1a(payload, size) != (uint32_t)get(batch + 4, 4))
+				break;
+			for (size_t i = 0; records != nullptr && i < size; i += RECORD_SIZE) {
+				const char* in = payload + i;
+				JournalRecord record;
+				record.type = (uint8_t)in[0];
+				record.a = (int32_t)get(in + 1, 4);
+				record.b = (int32_t)get(in + 5, 4);
+				record.c = (int32_t)get(in + 9, 4);
+				record.x = get_float(in + 13);
+				record.y = get_float(in + 17);
+				record.z = get_float(in + 21);
+				record.time = (int64_t)get(in + 25, 8);
+				records->push_back(record);
+			}
+			offset += BATCH_HEADER_SIZE + size;
+		}
+		return offset;
+	}
+
+	void apply(const JournalRecord& record, SaveData& data)
+	{
+		switch (record.type) {
+		case JournalRecord::CATCH:
+			data.collection.record_catch(record.a, record.b, record.time);
+			if (record.c && record.b == 1)
+				data.num_fish_caught_lake1++;
+			else if (record.c && record.b == 2)
+				data.num_fish_caught_lake2++;
+			break;
+		case JournalRecord::SELL:
+			data.collection.sell(record.a, std::max(record.c, 1));
+			data.gold = record.b;
+			break;
+		case JournalRecord::ROD_UPGRADE:
+			data.gold = record.a;
+			// the rod is repaired by as much as it's upgraded
+			data.dur_curr += record.x - data.dur_max;
+			data.dur_max = record.x;
+			data.dur_upgrades = record.y;
+			data.attack = record.b;
+			data.attack_upgrades = record.z;
+			break;
+		case JournalRecord::LURE_PURCHASE:
+			data.gold = record.a;
+			break;
+		case JournalRecord::RECRUIT:
+			if (record.a == 1)
+				data.ally1_recruited = true;
+			else if (record.a == 2)
+				data.ally2_recruited = true;
+			break;
+		case JournalRecord::LAKE_CHANGE:
+			// like the teleport: the middle of the other lake
+			data.lake_id = record.a;
+			data.currently_lake_1 = record.a == 1;
+			data.posX = (float)window_width_px / 2.f;
+			data.posY = (float)window_height_px / 2.f;
+			data.cameraX = 0.f;
+			data.cameraY = 0.f;
+			break;
+		default:
+			break;
+		}
+	}
+
+	JournalRecord make_record(uint8_t type, int32_t a, int32_t b = 0, int32_t c = 0)
+	{
+		JournalRecord record;
+		record.type = type;
+		record.a = a;
+		record.b = b;
+		record.c = c;
+		// FishingLog stamps itself with the current time
+		record.time = FishingLog().timestamp;
+		return record;
+	}
+}
+
+JournalRecord JournalRecord::caught(int species_id, int lake_id, bool counted)
+{
+	return make_record(CATCH, species_id, lake_id, counted ? 1 : 0);
+}
+
+JournalRecord JournalRecord::sold(int species_id, int gold, int count)
+{
+	return make_record(SELL, species_id, gold, count);
+}
+
+JournalRecord JournalRecord::rod_upgraded(int gold, float max_durability, float durability_upgrades, int attack, float attack_upgrades)
+{
+	JournalRecord record = make_record(ROD_UPGRADE, gold, attack);
+	record.x = max_durability;
+	record.y = durability_upgrades;
+	record.z = attack_upgrades;
+	return record;
+}
+
+JournalRecord JournalRecord::lure_bought(int gold)
+{
+	return make_record(LURE_PURCHASE, gold);
+}
+
+JournalRecord JournalRecord::recruited(int ally)
+{
+	return make_record(RECRUIT, ally);
+}
+
+JournalRecord JournalRecord::lake_changed(int lake_id)
+{
+	return make_record(LAKE_CHANGE, lake_id);
+}
+
+void SaveJournal::record(const JournalRecord& record)
+{
+	if (pending.empty())
+		pending_since_s = game_clock.now();
+	pending.push_back(record);
+}
+
+void SaveJournal::poll()
+{
+	if (!pending.empty() && game_clock.now() - pending_since_s >= FLUSH_INTERVAL_S)
+		flush();
+}
+
+void SaveJournal::flush()
+{
+	if (pending.empty())
+		return;
+	if (current.id == 0) {
+		// the records wait for the first full save, or there is none coming
+		if (!current.owns_slot)
+			pending.clear();
+		return;
+	}
+	save_service.append_journal_async(current.slot, current.id, encode_journal_batch(pending));
+	current.records += pending.size();
+	pending.clear();
+}
+
+bool SaveJournal::needs_full_save() const
+{
+	if (game_clock.now() < retry_at_s)
+		return false;
+	if (current.id == 0)
+		return current.owns_slot && !pending.empty();
+	return current.records + pending.size() >= COMPACT_RECORDS;
+}
+
+uint64_t SaveJournal::begin(int slot)
+{
+	// unique across runs, as long as the clock doesn't go back
+	uint64_t now = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+	static uint64_t last_id = 0;
+	last_id = std::max(last_id + 1, now);
+
+	current.slot = slot;
+	current.id = last_id;
+	current.records = 0;
+	current.owns_slot = true;
+	pending.clear();
+	return current.id;
+}
+
+void SaveJournal::save_failed(const JournalSession& previous)
+{
+	current = previous;
+	retry_at_s = game_clock.now() + RETRY_INTERVAL_S;
+}
+
+void SaveJournal::resume(const JournalSession& session)
+{
+	current = session;
+	pending.clear();
+}
+
+void SaveJournal::start_new_game(int slot)
+{
+	JournalSession session;
+	session.slot = slot;
+	session.owns_slot = !save_slots.used(slot);
+	resume(session);
+}
+
+void SaveJournal::detach(int slot)
+{
+	if (current.slot != slot)
+		return;
+	current.id = 0;
+	current.records = 0;
+	current.owns_slot = false;
+	pending.clear();
+}
+
+bool start_journal(const std::string& path, uint64_t journal_id)
+{
+	bool ok = write_file_atomic(path, header(journal_id));
+	bump_save_generation();
+	return ok;
+}
+
+bool append_journal(const std::string& path, uint64_t journal_id, const std::string& batch)
+{
+	// a batch cut short by a crash is written over, the ones after it would never be read
+	std::string bytes;
+	size_t end = read_file(path, bytes) ? read_batches(bytes, journal_id, nullptr) : 0;
+	if (end == 0) {
+		fprintf(stderr, "%s isn't the journal of the save, dropped %zu bytes\n", path.c_str(), batch.size());
+		return false;
+	}
+
+	FILE* file = fopen(path.c_str(), "r+b");
+	if (file == nullptr) {
+		fprintf(stderr, "Could not open %s to write\n", path.c_str());
+		return false;
+	}
+	bool ok = fseek(file, (long)end, SEEK_SET) == 0;
+	ok = ok && fwrite(batch.data(), 1, batch.size(), file) == batch.size() && fflush(file) == 0;
+	if (ok && end + batch.size() < bytes.size()) {
+#ifdef _WIN32
+		ok = _chsize_s(_fileno(file), (long long)(end + batch.size())) == 0;
+#else
+		ok = ftruncate(fileno(file), (off_t)(end + batch.size())) == 0;
+#endif
+	}
+#ifdef _WIN32
+	ok = ok && _commit(_fileno(file)) == 0;
+#else
+	ok = ok && fsync(fileno(file)) == 0;
+#endif
+	ok = fclose(file) == 0 && ok;
+	if (!ok)
+		fprintf(stderr, "Could not write %s\n", path.c_str());
+	bump_save_generation();
+	return ok;
+}
+
+std::string encode_journal_batch(const std::vector<JournalRecord>& records)
+{
+	std::string payload;
+	payload.reserve(records.size() * RECORD_SIZE);
+	for (const JournalRecord& record : records) {
+		put(payload, record.type, 1);
+		put(payload, (uint32_t)record.a, 4);
+		put(payload, (uint32_t)record.b, 4);
+		put(payload, (uint32_t)record.c, 4);
+		put_float(payload, record.x);
+		put_float(payload, record.y);
+		put_float(payload, record.z);
+		put(payload, (uint64_t)record.time, 8);
+	}
+	std::string batch;
+	batch.reserve(BATCH_HEADER_SIZE + payload.size());
+	put(batch, payload.size(), 4);
+	put(batch, fnv1a(payload.data(), payload.size()), 4);
+	return batch + payload;
+}
+
+size_t replay_journal(const std::string& path, SaveData& data)
+{
+	if (data.journal_id == 0)
+		return 0;
+	std::string bytes;
+	if (!read_file(path, bytes))
+		return 0;
+	std::vector<JournalRecord> records;
+	read_batches(bytes, data.journal_id, &records);
+	for (const JournalRecord& record : records)
+		apply(record, data);
+	return records.size();
+}
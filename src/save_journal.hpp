@@ -0,0 +1,122 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// internal
+#include "save_data.hpp"
+
+// One gameplay event since the last full save. The fields mean something else for every
+// type, the helpers below fill them in. Values that change in place (gold, the rod) are
+// journaled as they are after the event, so replaying never depends on the prices and
+// upgrade steps of the build.
+struct JournalRecord
+{
+	enum Type : uint8_t {
+		// a = species, b = lake, c = 1 if it counts towards the catches of the lake
+		CATCH = 1,
+		// a = species, b = gold after, c = number sold (0 in older journals, for one)
+		SELL = 2,
+		// a = gold after, b = attack, x = max durability, y = durability upgrades, z = attack upgrades
+		ROD_UPGRADE = 3,
+		// a = gold after, lures aren't saved
+		LURE_PURCHASE = 4,
+		// a = ally 1 or 2
+		RECRUIT = 5,
+		// a = lake
+		LAKE_CHANGE = 6,
+	};
+
+	uint8_t type = 0;
+	int32_t a = 0;
+	int32_t b = 0;
+	int32_t c = 0;
+	float x = 0.f;
+	float y = 0.f;
+	float z = 0.f;
+	// milliseconds since the epoch, like FishingLog::timestamp
+	int64_t time = 0;
+
+	static JournalRecord caught(int species_id, int lake_id, bool counted);
+	static JournalRecord sold(int species_id, int gold, int count = 1);
+	static JournalRecord rod_upgraded(int gold, float max_durability, float durability_upgrades, int attack, float attack_upgrades);
+	static JournalRecord lure_bought(int gold);
+	static JournalRecord recruited(int ally);
+	static JournalRecord lake_changed(int lake_id);
+};
+
+// Where the journal of a slot goes on top of
+struct JournalSession
+{
+	int slot = 0;
+	// SaveData::journal_id of the save in the slot, 0 while the game was never saved there
+	uint64_t id = 0;
+	// records written to the journal (or on their way) since that save
+	size_t records = 0;
+	// false if the slot holds a save of another game, records are dropped then
+	bool owns_slot = true;
+};
+
+// Autosaving by journal: instead of writing the whole game after every change, the events
+// that change what is saved are appended to a journal next to the save of the slot, and
+// loading the slot replays them on top of it (SaveSlots::load()).
+//
+// record() only adds the event to a batch in memory. poll() hands the batch to the save
+// service every couple of seconds, which appends it to the journal and flushes it to the
+// disk on its thread, so an event costs next to nothing and a crash loses the last few
+// seconds at most. Once the journal gets long, or there is no save to put it on top of
+// yet, needs_full_save() asks for a full save, which starts the journal over (compaction).
+//
+// The journal is "LOTLJRNL", a little endian uint32 version, the uint64 journal_id of the
+// save it belongs to, then batches: a uint32 size, a uint32 FNV-1a checksum and the
+// records. A batch cut short by a crash fails its checksum and it and the rest are ignored.
+class SaveJournal
+{
+public:
+	// full save once this many records are in the journal
+	static const size_t COMPACT_RECORDS = 512;
+
+	void record(const JournalRecord& record);
+	// Hands the batch over once it's old enough, from the main thread once per frame
+	void poll();
+	// Hands the batch over right away, before loading or quitting
+	void flush();
+
+	// true if a full save should be made of the game, see RenderSystem::autosave()
+	bool needs_full_save() const;
+	// For a full save of the game to the slot, returns the journal_id the save gets. The
+	// records in memory are part of the save and dropped.
+	uint64_t begin(int slot);
+	// The full save handed over with previous = session() before begin() didn't make it
+	void save_failed(const JournalSession& previous);
+
+	// A save was loaded (and its journal replayed) or the world was put back to one
+	void resume(const JournalSession& session);
+	// A new game that goes to the slot, unless another game is saved there
+	void start_new_game(int slot);
+	// The save of the slot was deleted
+	void detach(int slot);
+
+	const JournalSession& session() const { return current; }
+
+private:
+	JournalSession current;
+	std::vector<JournalRecord> pending;
+	// game_clock time of the oldest record in pending
+	double pending_since_s = 0.0;
+	// no full saves before then after one failed
+	double retry_at_s = 0.0;
+};
+
+// Writes a journal with no records for the save with the journal_id, replacing the old one
+bool start_journal(const std::string& path, uint64_t journal_id);
+// Appends a batch of encode_journal_batch() to the journal, false if the journal belongs to
+// another save or couldn't be written
+bool append_journal(const std::string& path, uint64_t journal_id, const std::string& batch);
+std::string encode_journal_batch(const std::vector<JournalRecord>& records);
+// Applies the records of the journal of the save onto it, returns how many there were
+size_t replay_journal(const std::string& path, SaveData& data);
+
+extern SaveJournal save_journal;
@@ -0,0 +1,119 @@
+// Header
+#include "save_service.hpp"
+
+// internal
+#include "alloc_tracker.hpp"
+#include "launch_options.hpp"
+#include "save_journal.hpp"
+#include "save_slots.hpp"
+
+SaveService save_service;
+
+SaveService::~SaveService()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	wake.notify_all();
+	// the queued saves are still written before the thread ends
+	if (thread.joinable())
+		thread.join();
+}
+
+void SaveService::save_async(int slot, SaveData data, std::string index, Callback done)
+{
+	Request request;
+	request.path = save_slots.path(slot);
+	request.json_path = save_slots.json_path(slot);
+	request.journal_path = save_slots.journal_path(slot);
+	request.data = std::move(data);
+	request.bytes = std::move(index);
+	request.done = std::move(done);
+	push(std::move(request));
+}
+
+void SaveService::append_journal_async(int slot, uint64_t journal_id, std::string batch)
+{
+	Request request;
+	request.journal = true;
+	request.journal_path = save_slots.journal_path(slot);
+	request.data.journal_id = journal_id;
+	request.bytes = std::move(batch);
+	push(std::move(request));
+}
+
+void SaveService::push(Request request)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		requests.push_back(std::move(request));
+		if (!thread.joinable())
+			thread = std::thread(&SaveService::thread_loop, this);
+	}
+	wake.notify_one();
+}
+
+void SaveService::poll()
+{
+	std::vector<Result> finished;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		finished.swap(results);
+	}
+	for (Result& result : finished) {
+		if (result.done)
+			result.done(result.ok);
+	}
+}
+
+void SaveService::flush()
+{
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		idle.wait(lock, [this]() { return requests.empty() && !writing; });
+	}
+	poll();
+}
+
+bool SaveService::busy() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return !requests.empty() || writing;
+}
+
+void SaveService::thread_loop()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true) {
+		wake.wait(lock, [this]() { return stopping || !requests.empty(); });
+		if (requests.empty())
+			return;
+		Request request = std::move(requests.front());
+		requests.pop_front();
+		writing = true;
+		lock.unlock();
+
+		MemoryScope memory_scope(MemoryTag::SAVES);
+		bool ok;
+		if (request.journal) {
+			ok = append_journal(request.journal_path, request.data.journal_id, request.bytes);
+		}
+		else {
+			ok = write_save(request.path, request.data);
+			if (ok && launch_options.save_json)
+				write_save_json(request.json_path, request.data);
+			if (ok) {
+				// the records so far are in the save now
+				start_journal(request.journal_path, request.data.journal_id);
+				write_file_atomic(SAVE_INDEX_PATH, request.bytes);
+			}
+		}
+
+		lock.lock();
+		writing = false;
+		results.push_back({ std::move(request.done), ok });
+		if (requests.empty())
+			idle.notify_all();
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// stlib
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// internal
+#include "save_data.hpp"
+
+// Writes saves on a thread of its own, so serializing and flushing them to the disk never
+// holds up a frame. It doesn't use the job system: a save can take a while on a slow disk,
+// and the main thread runs jobs of the job system while it waits for its systems.
+//
+// The main thread copies what is saved into a SaveData (RenderSystem::saveData()) and hands
+// it over with the save slot index that goes with it. Saves are written in the order they
+// were made, the index only once its save is on the disk, and the callbacks are called on
+// the main thread by poll() after that. Batches of the SaveJournal are appended on the same
+// thread, in order with the saves: a save starts the journal of its slot over.
+class SaveService
+{
+public:
+	// true if the save made it to the disk
+	using Callback = std::function<void(bool)>;
+
+	~SaveService();
+
+	void save_async(int slot, SaveData data, std::string index, Callback done);
+	void append_journal_async(int slot, uint64_t journal_id, std::string batch);
+	// Calls the callbacks of the finished saves, from the main thread once per frame
+	void poll();
+	// Waits until the saves handed over so far are written, before the game quits
+	void flush();
+
+	bool busy() const;
+
+private:
+	struct Request {
+		// a journal batch instead of a save if set
+		bool journal = false;
+		std::string path;
+		std::string json_path;
+		std::string journal_path;
+		SaveData data;
+		// the index for a save, the batch for the journal
+		std::string bytes;
+		Callback done;
+	};
+	void push(Request request);
+	struct Result {
+		Callback done;
+		bool ok;
+	};
+
+	void thread_loop();
+
+	mutable std::mutex mutex;
+	std::condition_variable wake;
+	std::condition_variable idle;
+	std::deque<Request> requests;
+	std::vector<Result> results;
+	bool writing = false;
+	bool stopping = false;
+	std::thread thread;
+};
+
+extern SaveService save_service;
@@ -0,0 +1,163 @@
+// Header
+#include "save_slots.hpp"
+
+// stlib
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <../cereal/archives/portable_binary.hpp>
+#include <../cereal/types/vector.hpp>
+
+// internal
+#include "game_clock.hpp"
+#include "save_journal.hpp"
+
+SaveSlots save_slots;
+
+namespace
+{
+	const char INDEX_MAGIC[8] = { 'L', 'O', 'T', 'L', 'S', 'I', 'D', 'X' };
+	const uint32_t INDEX_VERSION = 1;
+}
+
+void SaveSlots::select(int slot)
+{
+	if (slot >= 0 && slot < SLOT_COUNT)
+		current = slot;
+}
+
+const SaveSlotInfo& SaveSlots::info(int slot)
+{
+	load_index();
+	return slots[slot];
+}
+
+int SaveSlots::most_recent()
+{
+	load_index();
+	int recent = -1;
+	for (int slot = 0; slot < SLOT_COUNT; slot++) {
+		if (slots[slot].used && (recent < 0 || slots[slot].timestamp > slots[recent].timestamp))
+			recent = slot;
+	}
+	return recent;
+}
+
+std::string SaveSlots::path(int slot) const
+{
+	return slot == 0 ? SAVE_PATH : "../savedata" + std::to_string(slot + 1) + ".sav";
+}
+
+std::string SaveSlots::json_path(int slot) const
+{
+	return slot == 0 ? SAVE_JSON_PATH : "../savedata" + std::to_string(slot + 1) + ".json";
+}
+
+std::string SaveSlots::journal_path(int slot) const
+{
+	return slot == 0 ? "../savedata.jnl" : "../savedata" + std::to_string(slot + 1) + ".jnl";
+}
+
+std::string SaveSlots::set(int slot, const SaveSlotInfo& slot_info)
+{
+	load_index();
+	slots[slot] = slot_info;
+	changes++;
+	return index_bytes();
+}
+
+bool SaveSlots::load(int slot, SaveData& data, size_t* journal_records)
+{
+	if (!load_save(path(slot), json_path(slot), data))
+		return false;
+	size_t records = replay_journal(journal_path(slot), data);
+	if (journal_records != nullptr)
+		*journal_records = records;
+	return true;
+}
+
+void SaveSlots::remove(int slot)
+{
+	load_index();
+	delete_save(path(slot), json_path(slot));
+	std::remove(journal_path(slot).c_str());
+	slots[slot] = SaveSlotInfo();
+	changes++;
+	write_file_atomic(SAVE_INDEX_PATH, index_bytes());
+}
+
+void SaveSlots::start_playtime(double playtime_s)
+{
+	playtime_base_s = playtime_s;
+	playtime_start_s = game_clock.now();
+}
+
+double SaveSlots::playtime() const
+{
+	return playtime_base_s + (game_clock.now() - playtime_start_s);
+}
+
+void SaveSlots::load_index()
+{
+	if (loaded)
+		return;
+	loaded = true;
+	slots.assign(SLOT_COUNT, SaveSlotInfo());
+
+	std::ifstream is(SAVE_INDEX_PATH, std::ios::binary);
+	char magic[sizeof(INDEX_MAGIC)] = {};
+	unsigned char version[4] = {};
+	is.read(magic, sizeof(magic));
+	is.read((char*)version, sizeof(version));
+	uint32_t index_version = version[0] | (version[1] << 8) | (version[2] << 16) | ((uint32_t)version[3] << 24);
+	if (is && memcmp(magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 && index_version == INDEX_VERSION) {
+		try {
+			std::vector<SaveSlotInfo> index;
+			cereal::PortableBinaryInputArchive archive(is);
+			archive(index);
+			for (int slot = 0; slot < SLOT_COUNT && slot < (int)index.size(); slot++)
+				slots[slot] = std::move(index[slot]);
+			return;
+		}
+		catch (const std::exception& e) {
+			fprintf(stderr, "Could not read the save index %s: %s\n", SAVE_INDEX_PATH.c_str(), e.what());
+			slots.assign(SLOT_COUNT, SaveSlotInfo());
+		}
+	}
+	rebuild_index();
+}
+
+void SaveSlots::rebuild_index()
+{
+	bool any = false;
+	for (int slot = 0; slot < SLOT_COUNT; slot++) {
+		if (!file_has_data(path(slot)) && !file_has_data(json_path(slot)))
+			continue;
+		SaveData data;
+		if (!load(slot, data))
+			continue;
+		slots[slot].used = true;
+		slots[slot].gold = data.gold;
+		slots[slot].lake_id = data.lake_id;
+		any = true;
+	}
+	if (any)
+		write_file_atomic(SAVE_INDEX_PATH, index_bytes());
+}
+
+std::string SaveSlots::index_bytes() const
+{
+	std::ostringstream os(std::ios::binary);
+	os.write(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+	unsigned char version[4];
+	for (int i = 0; i < 4; i++)
+		version[i] = (unsigned char)(INDEX_VERSION >> (8 * i));
+	os.write((const char*)version, sizeof(version));
+	{
+		cereal::PortableBinaryOutputArchive archive(os);
+		archive(slots);
+	}
+	return os.str();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+// stlib
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// internal
+#include "save_data.hpp"
+
+// What the menus show of a save slot, kept in the index so they never open the saves
+struct SaveSlotInfo
+{
+	bool used = false;
+	double playtime_s = 0.0;
+	int gold = 0;
+	int lake_id = 1;
+	// seconds since the epoch, 0 if unknown (saves of builds without an index)
+	int64_t timestamp = 0;
+	// THUMBNAIL_WIDTH x THUMBNAIL_HEIGHT RGB, bottom row first like glReadPixels, or empty
+	std::vector<unsigned char> thumbnail;
+
+	template<class Archive>
+	void serialize(Archive & archive)
+	{
+		archive(CEREAL_NVP(used), CEREAL_NVP(playtime_s), CEREAL_NVP(gold), CEREAL_NVP(lake_id), CEREAL_NVP(timestamp), CEREAL_NVP(thumbnail));
+	}
+};
+
+// The save slots and their index file. The index is read once, on first use, and kept in
+// memory; it's rewritten (atomically, like the saves) whenever a slot is saved or deleted.
+// Without an index, e.g. the first run after saves of older builds, it's rebuilt from the
+// saves there are.
+//
+// The index is "LOTLSIDX", a little endian uint32 version, then the slots through
+// cereal's PortableBinaryArchive.
+class SaveSlots
+{
+public:
+	static const int SLOT_COUNT = 3;
+	static const int THUMBNAIL_WIDTH = 160;
+	static const int THUMBNAIL_HEIGHT = 90;
+
+	// the slot saves and loads go to
+	int selected() const { return current; }
+	void select(int slot);
+
+	const SaveSlotInfo& info(int slot);
+	bool used(int slot) { return info(slot).used; }
+	// The slot saved last, -1 if none is used
+	int most_recent();
+	// Goes up whenever the info of a slot changes, e.g. to upload new thumbnails
+	uint64_t revision() const { return changes; }
+
+	std::string path(int slot) const;
+	std::string json_path(int slot) const;
+	std::string journal_path(int slot) const;
+
+	// Changes the info of a slot in memory, and returns the bytes of the new index for the
+	// save service to write once the save is on the disk
+	std::string set(int slot, const SaveSlotInfo& slot_info);
+	// The save with its journal replayed on top, journal_records is set to the number of
+	// records replayed
+	bool load(int slot, SaveData& data, size_t* journal_records = nullptr);
+	// Deletes the save and its journal, and writes the index right away
+	void remove(int slot);
+
+	// Time played in the game running, continued from the save it was loaded from
+	void start_playtime(double playtime_s);
+	double playtime() const;
+
+private:
+	void load_index();
+	void rebuild_index();
+	std::string index_bytes() const;
+
+	bool loaded = false;
+	int current = 0;
+	uint64_t changes = 0;
+	std::vector<SaveSlotInfo> slots;
+	double playtime_base_s = 0.0;
+	double playtime_start_s = 0.0;
+};
+
+const std::string SAVE_INDEX_PATH = "../savedata.idx";
+
+extern SaveSlots save_slots;
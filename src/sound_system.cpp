@@ -3,16 +3,53 @@
 
 // stlib
 #include <cassert>
+#include <cstring>
 #include <sstream>
 #include <iostream>
 
 #include "tiny_ecs_registry.hpp"
+#include "alloc_tracker.hpp"
+#include "launch_options.hpp"
+
+// SDL's allocations, the sounds and music it decodes, are counted as audio with --track-memory
+static void* SDLCALL sdl_malloc(size_t size)
+{
+	return tracked_malloc(size, MemoryTag::AUDIO);
+}
+
+static void* SDLCALL sdl_calloc(size_t count, size_t size)
+{
+	if (size != 0 && count > SIZE_MAX / size)
+		return nullptr;
+	void* memory = tracked_malloc(count * size, MemoryTag::AUDIO);
+	if (memory != nullptr)
+		memset(memory, 0, count * size);
+	return memory;
+}
+
+static void* SDLCALL sdl_realloc(void* memory, size_t size)
+{
+	return memory != nullptr ? tracked_realloc(memory, size) : tracked_malloc(size, MemoryTag::AUDIO);
+}
+
+static void SDLCALL sdl_free(void* memory)
+{
+	tracked_free(memory);
+}
+
 bool SoundSystem::init(GAME_STATE_ID* game_state) {
 	this->current_game_state = game_state;
 	this->previous_game_state = *game_state;
 	this->previous_lake.id = 1;
 	//////////////////////////////////////
 // Loading music and sounds with SDL
+	// before SDL allocates anything
+	if (memory_tracker.enabled())
+		SDL_SetMemoryFunctions(sdl_malloc, sdl_calloc, sdl_realloc, sdl_free);
+	// headless runs (benchmarks, CI) may have no sound card, SDL's dummy driver still loads
+	// and "plays" everything so the game behaves the same, only silently
+	if (launch_options.headless)
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
 	if (SDL_Init(SDL_INIT_AUDIO) < 0)
 	{
 		fprintf(stderr, "Failed to initialize SDL Audio");
@@ -21,7 +58,7 @@ bool SoundSystem::init(GAME_STATE_ID* game_state) {
 	if (Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 2048) == -1)
 	{
 		fprintf(stderr, "Failed to open audio device");
-		return nullptr;
+		return false;
 	}
 
 	lake_one_world_bgm = Mix_LoadMUS(audio_path("lake_one_world_bgm.wav").c_str());
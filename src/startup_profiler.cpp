@@ -0,0 +1,105 @@
+// Header
+#include "startup_profiler.hpp"
+
+// stlib
+#include <cassert>
+#include <fstream>
+#include <iostream>
+
+#include <../nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+StartupProfiler startup_profiler;
+
+StartupProfiler::StartupProfiler()
+	: origin(Clock::now())
+{
+}
+
+double StartupProfiler::ms_since(Clock::time_point start)
+{
+	return (double)std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count() / 1000.0;
+}
+
+void StartupProfiler::begin(const std::string& name)
+{
+	Phase phase;
+	phase.name = name;
+	phase.depth = (int)open_phases.size();
+	phase.start_ms = ms_since(origin);
+	phase.duration_ms = 0.0;
+	open_phases.push_back((int)phases.size());
+	phases.push_back(phase);
+}
+
+void StartupProfiler::end()
+{
+	assert(!open_phases.empty() && "StartupProfiler::end() without matching begin()");
+	Phase& phase = phases[open_phases.back()];
+	phase.duration_ms = ms_since(origin) - phase.start_ms;
+	open_phases.pop_back();
+}
+
+void StartupProfiler::record_asset(const std::string& path, double decode_ms, double upload_ms)
+{
+	assets.push_back({ path, decode_ms, upload_ms });
+}
+
+void StartupProfiler::finish()
+{
+	total_ms = ms_since(origin);
+}
+
+void StartupProfiler::print_summary() const
+{
+	double decode_total = 0.0;
+	double upload_total = 0.0;
+	const Asset* slowest = nullptr;
+	for (const Asset& asset : assets) {
+		decode_total += asset.decode_ms;
+		upload_total += asset.upload_ms;
+		if (slowest == nullptr || asset.decode_ms + asset.upload_ms > slowest->decode_ms + slowest->upload_ms)
+			slowest = &asset;
+	}
+
+	printf("Startup took %.2f ms:\n", total_ms);
+	for (const Phase& phase : phases)
+		printf("%*s%-*s %9.2f ms\n", phase.depth * 2, "", 40 - phase.depth * 2, phase.name.c_str(), phase.duration_ms);
+	printf("%d textures: %.2f ms decode, %.2f ms upload\n", (int)assets.size(), decode_total, upload_total);
+	if (slowest != nullptr)
+		printf("slowest texture: %s (%.2f ms)\n", slowest->path.c_str(), slowest->decode_ms + slowest->upload_ms);
+}
+
+bool StartupProfiler::write_report(const std::string& path) const
+{
+	json report;
+	report["total_ms"] = total_ms;
+
+	json phase_list = json::array();
+	for (const Phase& phase : phases) {
+		phase_list.push_back({
+			{ "name", phase.name },
+			{ "depth", phase.depth },
+			{ "start_ms", phase.start_ms },
+			{ "duration_ms", phase.duration_ms } });
+	}
+	report["phases"] = phase_list;
+
+	json asset_list = json::array();
+	for (const Asset& asset : assets) {
+		asset_list.push_back({
+			{ "path", asset.path },
+			{ "decode_ms", asset.decode_ms },
+			{ "upload_ms", asset.upload_ms } });
+	}
+	report["assets"] = asset_list;
+
+	std::ofstream os(path);
+	if (!os) {
+		fprintf(stderr, "Could not write startup report to %s\n", path.c_str());
+		return false;
+	}
+	os << report.dump(2) << std::endl;
+	return true;
+}
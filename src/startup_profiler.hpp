@@ -0,0 +1,62 @@
+#pragma once
+
+// stlib
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Records how long each startup phase takes (window creation, audio, textures, shaders, ...)
+// and how long every texture spends being decoded vs uploaded to the GPU.
+// Phases can be nested; the summary is printed once startup is done and can also be
+// written out as JSON (see --startup-report=path in main.cpp) so CI can track regressions.
+class StartupProfiler
+{
+public:
+	using Clock = std::chrono::high_resolution_clock;
+
+	struct Phase {
+		std::string name;
+		int depth;
+		double start_ms; // relative to the profiler creation
+		double duration_ms;
+	};
+
+	struct Asset {
+		std::string path;
+		double decode_ms;
+		double upload_ms;
+	};
+
+	StartupProfiler();
+
+	// Opens / closes a (possibly nested) phase, prefer StartupScope over calling these directly
+	void begin(const std::string& name);
+	void end();
+
+	void record_asset(const std::string& path, double decode_ms, double upload_ms);
+
+	// Stops the total clock, called once the main loop is about to start
+	void finish();
+
+	void print_summary() const;
+	bool write_report(const std::string& path) const;
+
+	static double ms_since(Clock::time_point start);
+
+private:
+	Clock::time_point origin;
+	double total_ms = 0.0;
+	std::vector<Phase> phases;
+	std::vector<int> open_phases; // indices into phases
+	std::vector<Asset> assets;
+};
+
+extern StartupProfiler startup_profiler;
+
+// Times the enclosing scope as a single startup phase
+class StartupScope
+{
+public:
+	StartupScope(const char* name) { startup_profiler.begin(name); }
+	~StartupScope() { startup_profiler.end(); }
+};
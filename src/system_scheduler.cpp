@@ -0,0 +1,98 @@
+// Header
+#include "system_scheduler.hpp"
+
+// stlib
+#include <algorithm>
+#include <cassert>
+
+#include "frame_profiler.hpp"
+
+void SystemScheduler::add(const char* name, Access access, std::function<void()> run)
+{
+	Node node;
+	node.name = name;
+	node.access = std::move(access);
+	node.run = std::move(run);
+	nodes.push_back(std::move(node));
+	built = false;
+}
+
+bool SystemScheduler::conflicts(const Access& a, const Access& b)
+{
+	if (a.exclusive || b.exclusive)
+		return true;
+	auto contains = [](const std::vector<ContainerInterface*>& pools, ContainerInterface* pool) {
+		return std::find(pools.begin(), pools.end(), pool) != pools.end();
+	};
+	for (ContainerInterface* pool : a.writes) {
+		if (contains(b.writes, pool) || contains(b.reads, pool))
+			return true;
+	}
+	for (ContainerInterface* pool : b.writes) {
+		if (contains(a.reads, pool))
+			return true;
+	}
+	return false;
+}
+
+void SystemScheduler::build()
+{
+	for (Node& node : nodes) {
+		node.dependents.clear();
+		node.dependency_count = 0;
+	}
+	// edges only point forward, so the graph is acyclic and conflicting systems keep
+	// the order they were added in
+	for (size_t later = 0; later < nodes.size(); later++) {
+		for (size_t earlier = 0; earlier < later; earlier++) {
+			if (conflicts(nodes[earlier].access, nodes[later].access)) {
+				nodes[earlier].dependents.push_back((int)later);
+				nodes[later].dependency_count++;
+			}
+		}
+	}
+	remaining_dependencies.reset(new std::atomic<int>[nodes.size()]);
+	built = true;
+}
+
+void SystemScheduler::run(JobSystem& jobs)
+{
+	if (!built)
+		build();
+	assert(pending.load() == 0 && "SystemScheduler::run() is not reentrant");
+
+	// counted before anything is submitted, so pending can't reach 0 early
+	pending = (int)nodes.size();
+	for (size_t i = 0; i < nodes.size(); i++)
+		remaining_dependencies[i] = nodes[i].dependency_count;
+	for (size_t i = 0; i < nodes.size(); i++) {
+		if (nodes[i].dependency_count == 0)
+			submit(jobs, (int)i);
+	}
+	jobs.wait(pending);
+}
+
+void SystemScheduler::submit(JobSystem& jobs, int index)
+{
+	auto job = [this, &jobs, index]() {
+		{
+			// only recorded when the system happens to run on the main thread
+			ProfileScope scope(nodes[index].name);
+			nodes[index].run();
+		}
+		finished(jobs, index);
+	};
+	if (nodes[index].access.main_thread)
+		jobs.submit_main_thread(job, nullptr);
+	else
+		jobs.submit(job, nullptr);
+}
+
+void SystemScheduler::finished(JobSystem& jobs, int index)
+{
+	for (int dependent : nodes[index].dependents) {
+		if (--remaining_dependencies[dependent] == 0)
+			submit(jobs, dependent);
+	}
+	pending--;
+}
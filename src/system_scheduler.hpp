@@ -0,0 +1,65 @@
+#pragma once
+
+// stlib
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// internal
+#include "tiny_ecs.hpp"
+#include "job_system.hpp"
+
+// Runs the game systems as a dependency graph on the JobSystem.
+// Every system declares the registry pools it reads and writes. Two systems depend on each
+// other if one writes a pool the other reads or writes, and then they run in the order they
+// were added; systems that don't conflict run at the same time on different cores.
+//
+// Systems that touch more than they can sensibly list (WorldSystem creates and removes
+// entities of every kind) are exclusive: they conflict with everything.
+class SystemScheduler
+{
+public:
+	struct Access {
+		std::vector<ContainerInterface*> reads;
+		std::vector<ContainerInterface*> writes;
+		bool exclusive = false;
+		// GL, GLFW window and SDL calls are only safe from the main thread
+		bool main_thread = false;
+	};
+
+	static Access exclusive_access()
+	{
+		Access access;
+		access.exclusive = true;
+		access.main_thread = true;
+		return access;
+	}
+
+	// name must outlive the scheduler (it is also used as the profiler zone name)
+	void add(const char* name, Access access, std::function<void()> run);
+
+	// Computes the dependencies, called by run() when systems were added since the last run
+	void build();
+
+	// Runs every system once and returns when all of them are done
+	void run(JobSystem& jobs);
+
+private:
+	struct Node {
+		const char* name;
+		Access access;
+		std::function<void()> run;
+		std::vector<int> dependents;
+		int dependency_count = 0;
+	};
+
+	static bool conflicts(const Access& a, const Access& b);
+	void submit(JobSystem& jobs, int index);
+	void finished(JobSystem& jobs, int index);
+
+	std::vector<Node> nodes;
+	std::unique_ptr<std::atomic<int>[]> remaining_dependencies;
+	std::atomic<int> pending{ 0 };
+	bool built = false;
+};
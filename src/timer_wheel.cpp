@@ -0,0 +1,179 @@
+// Header
+#include "timer_wheel.hpp"
+
+// stlib
+#include <cassert>
+#include <cmath>
+
+TimerWheel::TimerWheel()
+{
+	for (int& head : heads)
+		head = NO_ENTRY;
+}
+
+TimerWheel::Handle TimerWheel::schedule(float delay_ms, Callback callback)
+{
+	int index;
+	if (!free_entries.empty()) {
+		index = free_entries.back();
+		free_entries.pop_back();
+	}
+	else {
+		index = (int)entries.size();
+		entries.emplace_back();
+	}
+	Entry& entry = entries[index];
+	// the time already accumulated towards the next tick counts towards the delay
+	float ticks = std::ceil((delay_ms + leftover_ms) / TICK_MS);
+	entry.deadline_tick = now_tick + (ticks < 1.f ? 1 : (uint64_t)ticks);
+	entry.callback = std::move(callback);
+	insert(index);
+	active_count++;
+	return ((Handle)entry.generation << 32) | (Handle)(index + 1);
+}
+
+bool TimerWheel::cancel(Handle handle)
+{
+	int index = entry_index(handle);
+	if (index == NO_ENTRY)
+		return false;
+	unlink(index);
+	release(index);
+	return true;
+}
+
+bool TimerWheel::pending(Handle handle) const
+{
+	return entry_index(handle) != NO_ENTRY;
+}
+
+float TimerWheel::remaining_ms(Handle handle) const
+{
+	int index = entry_index(handle);
+	if (index == NO_ENTRY)
+		return 0.f;
+	return (float)(entries[index].deadline_tick - now_tick) * TICK_MS - leftover_ms;
+}
+
+void TimerWheel::advance(float elapsed_ms)
+{
+	leftover_ms += elapsed_ms;
+	while (leftover_ms >= TICK_MS) {
+		leftover_ms -= TICK_MS;
+		now_tick++;
+
+		// when a wheel wraps around, the next slot of the one above is sorted down
+		for (int level = 1; level < LEVELS; level++) {
+			if ((now_tick & ((1ull << (level * SLOT_BITS)) - 1)) != 0)
+				break;
+			cascade(level);
+		}
+
+		int slot = (int)(now_tick & (SLOTS - 1));
+		if (heads[slot] == NO_ENTRY)
+			continue;
+		// moved to a list of its own, so callbacks can add timers to this slot (for a later
+		// round) or cancel the ones that are about to run
+		heads[FIRING_LIST] = heads[slot];
+		heads[slot] = NO_ENTRY;
+		for (int index = heads[FIRING_LIST]; index != NO_ENTRY; index = entries[index].next)
+			entries[index].list = FIRING_LIST;
+
+		while (heads[FIRING_LIST] != NO_ENTRY) {
+			int index = heads[FIRING_LIST];
+			unlink(index);
+			Callback callback = std::move(entries[index].callback);
+			release(index);
+			callback();
+		}
+	}
+}
+
+void TimerWheel::clear()
+{
+	for (size_t index = 0; index < entries.size(); index++) {
+		if (entries[index].list != NO_ENTRY) {
+			unlink((int)index);
+			release((int)index);
+		}
+	}
+}
+
+void TimerWheel::insert(int index)
+{
+	Entry& entry = entries[index];
+	uint64_t deadline = entry.deadline_tick > now_tick ? entry.deadline_tick : now_tick;
+	uint64_t delta = deadline - now_tick;
+	for (int level = 0; level < LEVELS; level++) {
+		if (delta < (1ull << ((level + 1) * SLOT_BITS))) {
+			int slot = (int)((deadline >> (level * SLOT_BITS)) & (SLOTS - 1));
+			link(index, level * SLOTS + slot);
+			return;
+		}
+	}
+	// beyond the top level, parked in the slot that comes around last
+	int top = LEVELS - 1;
+	int slot = (int)(((now_tick >> (top * SLOT_BITS)) + SLOTS - 1) & (SLOTS - 1));
+	link(index, top * SLOTS + slot);
+}
+
+void TimerWheel::link(int index, int list)
+{
+	Entry& entry = entries[index];
+	entry.list = list;
+	entry.prev = NO_ENTRY;
+	entry.next = heads[list];
+	if (heads[list] != NO_ENTRY)
+		entries[heads[list]].prev = index;
+	heads[list] = index;
+}
+
+void TimerWheel::unlink(int index)
+{
+	Entry& entry = entries[index];
+	assert(entry.list != NO_ENTRY);
+	if (entry.prev != NO_ENTRY)
+		entries[entry.prev].next = entry.next;
+	else
+		heads[entry.list] = entry.next;
+	if (entry.next != NO_ENTRY)
+		entries[entry.next].prev = entry.prev;
+	entry.list = NO_ENTRY;
+	entry.prev = NO_ENTRY;
+	entry.next = NO_ENTRY;
+}
+
+void TimerWheel::release(int index)
+{
+	Entry& entry = entries[index];
+	entry.callback = nullptr;
+	// invalidates every handle to the entry
+	entry.generation++;
+	free_entries.push_back(index);
+	active_count--;
+}
+
+void TimerWheel::cascade(int level)
+{
+	int slot = (int)((now_tick >> (level * SLOT_BITS)) & (SLOTS - 1));
+	int list = level * SLOTS + slot;
+	int index = heads[list];
+	heads[list] = NO_ENTRY;
+	while (index != NO_ENTRY) {
+		int next = entries[index].next;
+		insert(index);
+		index = next;
+	}
+}
+
+int TimerWheel::entry_index(Handle handle) const
+{
+	uint32_t index_plus_one = (uint32_t)(handle & 0xffffffffu);
+	uint32_t generation = (uint32_t)(handle >> 32);
+	if (index_plus_one == 0 || index_plus_one > entries.size())
+		return NO_ENTRY;
+	const Entry& entry = entries[index_plus_one - 1];
+	if (entry.generation != generation || entry.list == NO_ENTRY)
+		return NO_ENTRY;
+	return (int)index_plus_one - 1;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+// stlib
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Hierarchical timer wheel: callbacks are registered with a delay and run once it has
+// passed. Timers are sorted into LEVELS wheels of SLOTS slots, each level SLOTS times
+// coarser than the one below, and are moved down a level when the wheel above comes
+// around to their slot. advance() therefore only touches the slot of each passed tick and
+// the timers that expire (plus the occasional cascade), no matter how many are waiting.
+//
+// Resolution is TICK_MS. Timers further out than the top level covers (~4.6 hours) are
+// parked in its last slot and re-sorted when it comes around.
+class TimerWheel
+{
+public:
+	// 0 is never a valid handle
+	using Handle = uint64_t;
+	using Callback = std::function<void()>;
+
+	static constexpr float TICK_MS = 1.f;
+	static const int SLOT_BITS = 6;
+	static const int SLOTS = 1 << SLOT_BITS;
+	static const int LEVELS = 4;
+
+	TimerWheel();
+
+	// Runs callback once delay_ms have passed, at the earliest on the next tick.
+	// Callbacks may schedule and cancel timers, including their own handle.
+	Handle schedule(float delay_ms, Callback callback);
+	// Returns false if the timer already ran or was cancelled
+	bool cancel(Handle handle);
+	bool pending(Handle handle) const;
+	// Time left until a pending timer runs, 0 otherwise
+	float remaining_ms(Handle handle) const;
+
+	// Moves time forward and runs every timer that expired, in deadline order
+	void advance(float elapsed_ms);
+
+	// Drops every timer without running it
+	void clear();
+
+	size_t size() const { return active_count; }
+
+private:
+	static const int NO_ENTRY = -1;
+	// list holding the timers that expire during the current tick
+	static const int FIRING_LIST = LEVELS * SLOTS;
+
+	struct Entry {
+		uint64_t deadline_tick = 0;
+		Callback callback;
+		uint32_t generation = 1;
+		int list = NO_ENTRY; // slot list the entry is linked into, NO_ENTRY if free
+		int prev = NO_ENTRY;
+		int next = NO_ENTRY;
+	};
+
+	void insert(int index);
+	void link(int index, int list);
+	void unlink(int index);
+	void release(int index);
+	void cascade(int level);
+	int entry_index(Handle handle) const;
+
+	std::vector<Entry> entries;
+	std::vector<int> free_entries;
+	int heads[LEVELS * SLOTS + 1];
+	uint64_t now_tick = 0;
+	float leftover_ms = 0.f;
+	size_t active_count = 0;
+};
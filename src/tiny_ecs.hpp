@@ -1,6 +1,10 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
 #include <vector>
 #include <unordered_map>
 #include <set>
@@ -8,6 +12,8 @@
 #include <typeindex>
 #include <assert.h>
 
+#include "alloc_tracker.hpp"
+
 // Unique identifyer for all entities
 class Entity
 {
@@ -22,6 +28,54 @@ public:
 	operator unsigned int() { return id; } // this enables automatic casting to int
 };
 
+// The components of every container at one point in time, see ECSRegistry::snapshot().
+// Entities and trivially copyable components are copied into one buffer, containers of
+// other components (strings, vectors, ...) keep a copy of their component vector.
+class RegistrySnapshot
+{
+public:
+	bool empty() const { return bytes.empty(); }
+	void clear() { bytes.clear(); objects.clear(); }
+	size_t size_bytes() const { return bytes.size(); }
+
+	// Appends size bytes, each block starts aligned for any component
+	void write(const void* data, size_t size)
+	{
+		size_t offset = (bytes.size() + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+		bytes.resize(offset + size);
+		if (size > 0)
+			memcpy(bytes.data() + offset, data, size);
+	}
+	void write_object(std::shared_ptr<const void> object) { objects.push_back(std::move(object)); }
+
+	// Reads the blocks back in the order they were written
+	class Reader
+	{
+	public:
+		explicit Reader(const RegistrySnapshot& snapshot) : snapshot(snapshot) {}
+		const void* read(size_t size)
+		{
+			offset = (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+			assert(offset + size <= snapshot.bytes.size() && "Read past the end of the snapshot");
+			const void* data = snapshot.bytes.data() + offset;
+			offset += size;
+			return data;
+		}
+		const void* read_object() { return snapshot.objects[object++].get(); }
+
+	private:
+		const RegistrySnapshot& snapshot;
+		size_t offset = 0;
+		size_t object = 0;
+	};
+
+private:
+	static const size_t ALIGNMENT = 16;
+
+	std::vector<char> bytes;
+	std::vector<std::shared_ptr<const void>> objects;
+};
+
 // Common interface to refer to all containers in the ECS registry
 struct ContainerInterface
 {
@@ -29,6 +83,8 @@ struct ContainerInterface
 	virtual size_t size() = 0;
 	virtual void remove(Entity e) = 0;
 	virtual bool has(Entity entity) = 0;
+	virtual void snapshot(RegistrySnapshot& snapshot) = 0;
+	virtual void restore(RegistrySnapshot::Reader& reader) = 0;
 };
 
 // A container that stores components of type 'Component' and associated entities
@@ -36,6 +92,24 @@ template <typename Component> // A component can be any class
 class ComponentContainer : public ContainerInterface
 {
 private:
+	void snapshot_components(RegistrySnapshot& snapshot, std::true_type)
+	{
+		snapshot.write(components.data(), components.size() * sizeof(Component));
+	}
+	void snapshot_components(RegistrySnapshot& snapshot, std::false_type)
+	{
+		snapshot.write_object(std::make_shared<const std::vector<Component>>(components));
+	}
+	void restore_components(RegistrySnapshot::Reader& reader, size_t count, std::true_type)
+	{
+		const Component* first = static_cast<const Component*>(reader.read(count * sizeof(Component)));
+		components.assign(first, first + count);
+	}
+	void restore_components(RegistrySnapshot::Reader& reader, size_t count, std::false_type)
+	{
+		components = *static_cast<const std::vector<Component>*>(reader.read_object());
+	}
+
 	// The hash map from Entity -> array index.
 	std::unordered_map<unsigned int, unsigned int> map_entity_componentID; // the entity is cast to uint to be hashable.
 	bool registered = false;
@@ -63,6 +137,8 @@ public:
 	{
 		// Usually, every entity should only have one instance of each component type
 		assert(!(check_for_duplicates && has(e)) && "Entity already contained in ECS registry");
+		// growing the pool is the ECS's, the component was built by the caller
+		MemoryScope memory_scope(MemoryTag::ECS);
 
 		map_entity_componentID[e] = (unsigned int)components.size();
 		components.push_back(std::move(c)); // the move enforces move instead of copy constructor
@@ -127,6 +203,29 @@ public:
 		return components.size();
 	}
 
+	// Copies the components and their entities into the snapshot, in one block each if the
+	// components are trivially copyable
+	void snapshot(RegistrySnapshot& snapshot)
+	{
+		uint64_t count = entities.size();
+		snapshot.write(&count, sizeof(count));
+		snapshot.write(entities.data(), entities.size() * sizeof(Entity));
+		snapshot_components(snapshot, std::is_trivially_copyable<Component>());
+	}
+
+	// Replaces the components with the ones of the snapshot
+	void restore(RegistrySnapshot::Reader& reader)
+	{
+		size_t count = (size_t)*static_cast<const uint64_t*>(reader.read(sizeof(uint64_t)));
+		const Entity* first = static_cast<const Entity*>(reader.read(count * sizeof(Entity)));
+		entities.assign(first, first + count);
+		restore_components(reader, count, std::is_trivially_copyable<Component>());
+		map_entity_componentID.clear();
+		map_entity_componentID.reserve(count);
+		for (unsigned int i = 0; i < entities.size(); i++)
+			map_entity_componentID[entities[i]] = i;
+	}
+
 	// Sort the components and associated entity assignment structures by the comparisonFunction, see std::sort
 	template <class Compare>
 	void sort(Compare comparisonFunction)
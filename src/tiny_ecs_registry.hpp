@@ -33,8 +33,6 @@ public:
 	ComponentContainer<vec3> colors;
 	ComponentContainer<LakeId> lakes;
 	ComponentContainer<Wallet> wallet;
-	ComponentContainer<FishingLog> fishingLog;
-	ComponentContainer<Fish> fishInventory;
 	ComponentContainer<Gift> giftInventory;
 	ComponentContainer<Lure> lures;
 	ComponentContainer<EquipLure> luresEquipped; // index of registry.lures
@@ -63,7 +61,6 @@ public:
 	{
 		// TODO: A1 add a LightUp component
 		registry_list.push_back(&wallet);
-		registry_list.push_back(&fishingLog);
 		registry_list.push_back(&deathTimers);
 		registry_list.push_back(&fishingTimers);
 		registry_list.push_back(&shadowTimers);
@@ -83,7 +80,6 @@ public:
 		registry_list.push_back(&debugComponents);
 		registry_list.push_back(&colors);
 		registry_list.push_back(&lakes);
-		registry_list.push_back(&fishInventory);
 		registry_list.push_back(&lures);
 		registry_list.push_back(&luresEquipped);
 		registry_list.push_back(&fishables);
@@ -101,6 +97,9 @@ public:
 		registry_list.push_back(&dialogues);
 		registry_list.push_back(&bosses);
 		registry_list.push_back(&lightUp);
+		registry_list.push_back(&giftInventory);
+		registry_list.push_back(&stats);
+		registry_list.push_back(&friendshipLevels);
 	}
 
 	void clear_all_components() {
@@ -108,11 +107,19 @@ public:
 			reg->clear();
 	}
 
-	void list_all_components() {
-		printf("Debug info on all registry entries:\n");
+	// Calls fn(type_name, count) for every non-empty container
+	template <class Fn>
+	void for_each_component_count(Fn fn) {
 		for (ContainerInterface* reg : registry_list)
 			if (reg->size() > 0)
-				printf("%4d components of type %s\n", (int)reg->size(), typeid(*reg).name());
+				fn(typeid(*reg).name(), reg->size());
+	}
+
+	void list_all_components() {
+		printf("Debug info on all registry entries:\n");
+		for_each_component_count([](const char* type_name, size_t count) {
+			printf("%4d components of type %s\n", (int)count, type_name);
+		});
 	}
 
 	void list_all_components_of(Entity e) {
@@ -127,6 +134,22 @@ public:
 			reg->remove(e);
 	}
 
+	// Copies every container into the snapshot, restore() puts them back as they were. The
+	// cost is a copy of the components, it doesn't depend on how they were created.
+	void snapshot(RegistrySnapshot& snapshot) {
+		snapshot.clear();
+		for (ContainerInterface* reg : registry_list)
+			reg->snapshot(snapshot);
+	}
+
+	// Entities created after the snapshot are gone, their ids aren't handed out again
+	void restore(const RegistrySnapshot& snapshot) {
+		assert(!snapshot.empty() && "Restoring a snapshot that was never taken");
+		RegistrySnapshot::Reader reader(snapshot);
+		for (ContainerInterface* reg : registry_list)
+			reg->restore(reader);
+	}
+
 };
 
 extern ECSRegistry registry;
\ No newline at end of file
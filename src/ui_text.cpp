@@ -0,0 +1,59 @@
+// Header
+#include "ui_text.hpp"
+
+// stlib
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+// internal
+#include "common.hpp"
+#include "components.hpp"
+#include "linear_arena.hpp"
+
+const char* ui_format(const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	const char* text = ui_vformat(format, args);
+	va_end(args);
+	return text;
+}
+
+const char* ui_vformat(const char* format, va_list args)
+{
+	va_list measure;
+	va_copy(measure, args);
+	int length = vsnprintf(nullptr, 0, format, measure);
+	va_end(measure);
+	if (length < 0)
+		return "";
+	char* text = (char*)frame_arena.allocate((size_t)length + 1, 1);
+	vsnprintf(text, (size_t)length + 1, format, args);
+	return text;
+}
+
+const char* intern(const std::string& text)
+{
+	// nodes don't move, the strings in them stay where they are
+	static std::unordered_set<std::string> strings;
+	auto it = strings.find(text);
+	if (it == strings.end())
+		it = strings.insert(text).first;
+	return it->c_str();
+}
+
+const char* species_name(int species_id)
+{
+	static std::vector<const char*> names;
+	if (names.empty()) {
+		for (const auto& species : id_to_fish_species) {
+			if (species.first >= (int)names.size())
+				names.resize(species.first + 1, "");
+			names[species.first] = intern(species.second.name);
+		}
+	}
+	if (species_id < 0 || species_id >= (int)names.size())
+		return "";
+	return names[species_id];
+}
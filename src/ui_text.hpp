@@ -0,0 +1,26 @@
+#pragma once
+
+// stlib
+#include <cstdarg>
+#include <string>
+
+// internal
+#include "../imgui/imgui.h"
+
+// Text for the ImGui panels without heap allocations: formatted text goes into the frame
+// arena (frame_arena) instead of a std::string, and names that are shown every frame are
+// interned once and then passed around as const char*.
+//
+// ImGui copies what it's given, so the text only needs to live until the end of the frame:
+//   ImGui::Button(ui_format("SELL##%d", species_id), size);
+
+// printf into the frame arena, valid until the end of the frame
+const char* ui_format(const char* format, ...) IM_FMTARGS(1);
+const char* ui_vformat(const char* format, va_list args) IM_FMTLIST(1);
+
+// A copy of the text that lives as long as the game, the same pointer for equal texts.
+// Only the first call for a text allocates.
+const char* intern(const std::string& text);
+
+// Interned name of the fish species, "" for unknown ids
+const char* species_name(int species_id);
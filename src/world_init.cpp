@@ -1,5 +1,6 @@
 #include "world_init.hpp"
 #include "tiny_ecs_registry.hpp"
+#include "fish_collection.hpp"
 
 /**
  * @brief Fishing system
@@ -46,26 +47,16 @@ Entity createPlayer(RenderSystem* renderer, vec2 pos, int gold, int lake_id)
 
 Entity createFish(RenderSystem* renderer, FishSpecies& species, int lake_id)
 {
-    // Reserve en entity
+    // Into the inventory and the fishing log
+    fish_collection.record_catch(species.id, lake_id);
+
+    // Reserve en entity, only to show the caught fish
     auto entity = Entity();
 
     // Store a reference to the potentially re-used mesh object
     Mesh& mesh = renderer->getMesh(GEOMETRY_BUFFER_ID::SPRITE);
     registry.meshPtrs.emplace(entity, &mesh);
 
-    // Initialize in inventory, make sellable
-    Sellable& sellable = registry.sellableItems.emplace(entity);
-    sellable.price = (float) species.price;
-
-    // Create an (empty) Fish component to be able to refer to all fish
-    Fish& fish = registry.fishInventory.emplace(entity);
-    fish.species_id = species.id;
-	fish.lake_id = lake_id;
-
-	FishingLog& log = registry.fishingLog.emplace(entity);
-	log.species_id = species.id;
-	log.lake_id = lake_id;
-
     registry.renderRequests.insert(
             entity,
             { TEXTURE_ASSET_ID::TEXTURE_COUNT,
@@ -377,6 +368,11 @@ Entity createPartyMember(RenderSystem* renderer, std::string name, int attack, i
     return entity;
 }
 
+Entity createPartyMember(RenderSystem* renderer, const PartyMember& member) {
+    const Stats& s = member.stats;
+    return createPartyMember(renderer, member.name, s.attack, s.healing_bonus, s.speed, s.critical_rate, s.critical_value, member.skills, member.texture_id, member.menu_texture_id, member.description);
+}
+
 Entity createExclamationMark(RenderSystem* renderer) {
     auto entity = Entity();
 
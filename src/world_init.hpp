@@ -22,7 +22,7 @@ const float UI_HEIGHT = 0.5f* 900.f;
 
 // the player
 Entity createPlayer(RenderSystem* renderer, vec2 pos, int gold, int lake_id);
-// the prey
+// the prey, records the catch in fish_collection and returns an entity showing the fish
 Entity createFish(RenderSystem* renderer, FishSpecies& species, int lake_id);
 // the enemy
 Entity createFishShadow(RenderSystem* renderer, vec2 position);
@@ -48,6 +48,8 @@ Entity createBG(RenderSystem* renderer, vec2 pos);
 Entity createEnemy(RenderSystem* renderer, FishSpecies species, std::vector<Skill> skills);
 
 Entity createPartyMember(RenderSystem* renderer, std::string name, int attack, int healing_bonus, int speed, float crit_rate, float crit_value, std::vector<Skill> skills, TEXTURE_ASSET_ID battle_id, TEXTURE_ASSET_ID menu_id, std::string desc);
+// a member as made by mcPartyMember() etc. in battle_core.hpp
+Entity createPartyMember(RenderSystem* renderer, const PartyMember& member);
 
 Entity createExclamationMark(RenderSystem* renderer);
 
@@ -12,9 +12,17 @@
 
 #include "physics_system.hpp"
 #include "battle_system.hpp"
+#include "startup_profiler.hpp"
+#include "launch_options.hpp"
+#include "input_queue.hpp"
+#include "save_data.hpp"
+#include "save_service.hpp"
+#include "save_slots.hpp"
+#include "fish_collection.hpp"
 
 extern bool partyMemberOneAdded;
 extern Transform viewMatrix;
+extern Transform previousViewMatrix;
 bool rightKeyDown = false;
 bool leftKeyDown = false;
 bool upKeyDown = false;
@@ -43,8 +51,6 @@ bool currently_lake_1 = true;
 WorldSystem::WorldSystem()
         : next_fishshadow_spawn(0.f)
         , next_fish_spawn(0.f) {
-    // Seeding rng with random device
-    rng = std::default_random_engine(std::random_device()());
 }
 
 WorldSystem::~WorldSystem()
@@ -103,47 +109,98 @@ GLFWwindow *WorldSystem::create_window()
 #endif
 	glfwWindowHint(GLFW_RESIZABLE, 0);
 
-    // Get device resolution
-    const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
-    device_width = mode->width;
-    device_height = mode->height;
-
-    // subtracting from height to account for potential OS taskbars
-    device_height -= 100;
     int w, h;
-    // assume that monitor width > height
-    w = window_width_px * device_height / window_height_px;
-    h = device_height;
-    // if width ends up being larger than screen width
-    if (w > device_width) {
+    if (launch_options.headless) {
+        // Nothing is shown, the game draws into an offscreen framebuffer of a fixed size.
+        // GLFW 3.2 has no surfaceless or null platform, so a hidden window still provides the
+        // context and a display is needed (run under Xvfb on machines without one). When
+        // the display has no GLX the context is created with EGL instead, see below.
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        device_width = launch_options.headless_width;
+        device_height = launch_options.headless_height;
         w = device_width;
-        h = window_height_px * device_width / window_width_px;
+        h = device_height;
+    }
+    else {
+        // Get device resolution
+        const GLFWvidmode *mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        device_width = mode->width;
+        device_height = mode->height;
+
+        // subtracting from height to account for potential OS taskbars
+        device_height -= 100;
+        // assume that monitor width > height
+        w = window_width_px * device_height / window_height_px;
+        h = device_height;
+        // if width ends up being larger than screen width
+        if (w > device_width) {
+            w = device_width;
+            h = window_height_px * device_width / window_width_px;
+        }
     }
 
 	// Create the main window (for rendering, keyboard, and mouse input)
 	window = glfwCreateWindow(w, h, "Lord of the Lakes", nullptr, nullptr);
+    if (window == nullptr && launch_options.headless) {
+        fprintf(stderr, "No native OpenGL context, trying EGL\n");
+        glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+        window = glfwCreateWindow(w, h, "Lord of the Lakes", nullptr, nullptr);
+    }
 	if (window == nullptr) {
 		fprintf(stderr, "Failed to glfwCreateWindow");
 		return nullptr;
 	}
-    // set the window so that it always appears from the top of the screen, including title bar, and is centered
-    int title_bar_height;
-    glfwGetWindowFrameSize(window, NULL, &title_bar_height, NULL, NULL);
-    glfwSetWindowPos(window, device_width/2 - w/2, title_bar_height);
-	// Setting callbacks to member functions (that's why the redirect is needed)
+    if (!launch_options.headless) {
+        // set the window so that it always appears from the top of the screen, including title bar, and is centered
+        int title_bar_height;
+        glfwGetWindowFrameSize(window, NULL, &title_bar_height, NULL, NULL);
+        glfwSetWindowPos(window, device_width/2 - w/2, title_bar_height);
+    }
 	// Input is handled using GLFW, for more info see
 	// http://www.glfw.org/docs/latest/input_guide.html
+	// The callbacks only queue it, main() passes it to handle_input() at the start of the
+	// next simulation step (see input_queue.hpp)
 	glfwSetWindowUserPointer(window, this);
 	auto key_redirect = [](GLFWwindow *wnd, int _0, int _1, int _2, int _3)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_key(_0, _1, _2, _3); };
+	{
+		InputEvent event;
+		event.type = InputEvent::KEY;
+		event.code = _0;
+		event.action = _2;
+		event.mods = _3;
+		input_queue.push(event);
+	};
 	auto cursor_pos_redirect = [](GLFWwindow *wnd, double _0, double _1)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_mouse_move({_0, _1}); };
+	{
+		InputEvent event;
+		event.type = InputEvent::MOUSE_MOVE;
+		event.x = (float)_0;
+		event.y = (float)_1;
+		input_queue.push(event);
+	};
 	glfwSetKeyCallback(window, key_redirect);
 	glfwSetCursorPosCallback(window, cursor_pos_redirect);
 
 	auto mouse_button_callback = [](GLFWwindow *wnd, int _0, int _1, int _2)
-	{ ((WorldSystem *)glfwGetWindowUserPointer(wnd))->on_mouse_button(_0, _1, _2); };
+	{
+		InputEvent event;
+		event.type = InputEvent::MOUSE_BUTTON;
+		event.code = _0;
+		event.action = _1;
+		event.mods = _2;
+		input_queue.push(event);
+	};
 	glfwSetMouseButtonCallback(window, mouse_button_callback);
+	// the game doesn't scroll, it's queued so replays can scroll the UI
+	auto scroll_callback = [](GLFWwindow *wnd, double _0, double _1)
+	{
+		InputEvent event;
+		event.type = InputEvent::SCROLL;
+		event.x = (float)_0;
+		event.y = (float)_1;
+		input_queue.push(event);
+	};
+	glfwSetScrollCallback(window, scroll_callback);
 
 	return window;
 }
@@ -153,11 +210,17 @@ void WorldSystem::init(RenderSystem *renderer_arg, SoundSystem* sound_system_arg
     this->renderer = renderer_arg;
     this->sound_system = sound_system_arg;
     this->current_game_state = game_state_arg;
+    rng = rng_service.stream("world");
     // Playing background music indefinitely
     //Mix_PlayMusic(background_music, -1);
     //fprintf(stderr, "Loaded music\n");
     //sound_system->playBGM(sound_system->lake_one_bgm);
+    {
+        StartupScope scope("fish_tables");
+        lake_fish_tables = build_lake_fish_tables();
+    }
     // Set all states to default
+    StartupScope scope("restart_game");
     restart_game();
 }
 
@@ -183,23 +246,8 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
         registry.pendingCaughtFish.remove(entity);
     }
 
-    float min_timer_ms = 100.f;
-
-    for (Entity entity : registry.deathTimers.entities) {
-        // progress timer
-        DeathTimer& timer = registry.deathTimers.get(entity);
-        timer.timer_ms -= elapsed_ms_since_last_update;
-        if(timer.timer_ms < min_timer_ms){
-            min_timer_ms = timer.timer_ms;
-        }
-
-        if (timer.timer_ms < 0) {
-            registry.deathTimers.remove(entity);
-            registry.colors.get(entity) = vec3(1, 0.8f, 0.8f);
-            registry.motions.get(entity).velocity = vec2(0, 0);
-            return true;
-        }
-    }
+    // runs the callbacks of the shiny spot and fishing timers that expired
+    timers.advance(elapsed_ms_since_last_update);
 
     if (registry.shinySpots.size() < 2) {
         if (shiny_spot_timer_ms > 0) {
@@ -212,28 +260,20 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
             if (num <= 1.f) {
                 // set initial random position
                 vec2 pos = vec2(uniform_dist(rng) * (window_width_px), uniform_dist(rng) * (window_height_px));
-                createShinySpot(renderer, pos, { 10, 0 });
+                Entity spot = createShinySpot(renderer, pos, { 10, 0 });
+                start_remove_entity_timer(spot);
             }
             shiny_spot_timer_ms = 5000.f;
         }
     }
 
-    for (Entity entity : registry.removeEntityTimers.entities) {
-        // progress timer
-        RemoveEntityTimer& timer = registry.removeEntityTimers.get(entity);
-
-        // remove light up
-        if (registry.lightUp.has(player) && !registry.collisions.has(entity)) {
-            registry.lightUp.remove(player);
-        }
-
-        timer.timer_ms -= elapsed_ms_since_last_update;
-        if(timer.timer_ms < min_timer_ms){
-            min_timer_ms = timer.timer_ms;
-        }
-
-        if (timer.timer_ms < 0) {
-            registry.remove_all_components_of(entity);
+    // remove light up
+    if (registry.lightUp.has(player)) {
+        for (Entity entity : registry.removeEntityTimers.entities) {
+            if (!registry.collisions.has(entity)) {
+                registry.lightUp.remove(player);
+                break;
+            }
         }
     }
 
@@ -242,6 +282,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
     if (registry.fishShadows.size() < MAX_FISHSHADOW) {
         if (shadow_timer_ms < 0.f) {
             Entity entity = createFishShadow(renderer, { 0,0 });
+            start_shadow_timer(entity);
             // Setting random initial position and constant velocity
             Motion& motion = registry.motions.get(entity);
             motion.position =
@@ -257,36 +298,6 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
     // reduce window brightness if any of the present salmons is dying
     //screen.screen_darken_factor = 1 - min_timer_ms / 3000;
 
-    // fishing timer indicates the amount of time spent waiting for a catch
-    float fishing_min_timer_ms = 3000.f;
-    for (Entity entity : registry.fishingTimers.entities)
-    {
-        // progress timer
-        FishingTimer &timer = registry.fishingTimers.get(entity);
-        timer.timer_ms -= elapsed_ms_since_last_update;
-        if (timer.timer_ms < fishing_min_timer_ms)
-        {
-            fishing_min_timer_ms = timer.timer_ms;
-        }
-        //FishSpecies species = id_to_fish_species.at(timer.fish.species_id);
-        // catch the fish once the timer expired
-        if (timer.timer_ms < 0)
-        {
-            // Entity caught_fish = createFish(renderer, species);
-            timer = registry.fishingTimers.get(entity);
-            registry.fishingTimers.remove(entity);
-
-            registry.renderRequests.get(exclamation).is_visible = true;
-            //Mix_PlayChannel(-1, catch_alert, 0);
-            sound_system->playSound(sound_system->catch_alert);
-            setPositionRelativeToPlayer(registry.motions.get(exclamation), vec2(50.f, 80.f), vec2(50.f, 80.f), vec2(0.f, 90.f), vec2(0.f, 110.f));
-            catch_chance_timer = 1500.f;
-
-			// Entity caught_fish = createFish(renderer, species, static_cast<int>(lakeEntity)); // TODO: give lake an actual id
-            // registry.fishingTimers.remove(entity);
-        }
-
-    }
     // catching chance timer indicates the amount of time the player has the chance to mouse click and trigger a catch
     if (catch_chance_timer < 0) {
         registry.renderRequests.get(exclamation).is_visible = false;
@@ -300,9 +311,9 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
     for (Entity entity : registry.catchingBars.entities) {
       // progress timer
       struct CatchingBar& cb = registry.catchingBars.get(entity);
-      cb.filled -= elapsed_ms_since_last_update / 8000.f;
+      cb.filled -= elapsed_ms_since_last_update / CATCHING_BAR_DRAIN_MS;
 
-      if (cb.filled <= 0.1) {
+      if (cb.filled <= CATCHING_BAR_ESCAPE) {
           registry.renderRequests.get(catchingBar).is_visible = false;
           registry.catchingBars.remove(entity);
           setSpriteFrames(player_sprite, 0, 0, 0, 1);
@@ -339,7 +350,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 
     // when catching animation finishes, start showing fish
     if (player_sprite.current_frame == 3 && !is_catching && is_fish_caught) {
-        show_fish_timer = 1500.f;
+        show_fish_timer = SHOW_FISH_MS;
         setSpriteFrames(player_sprite, 7, 7, 7, 1);
             // remove motion removes the caught fish from rendering
         registry.renderRequests.get(caughtFish).is_visible = true;
@@ -348,8 +359,8 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
 
     // display the caught fish for 1.5 seconds
     if (show_fish_timer < 0.f && !is_fish_caught && registry.motions.has(caughtFish)) {
-        // remove motion removes the caught fish from rendering
-        registry.motions.remove(caughtFish);
+        // the catch is in fish_collection, the entity was only there to show it
+        registry.remove_all_components_of(caughtFish);
         setSpriteFrames(player_sprite, 0, 0, 0, 1);
     }
     else {
@@ -360,7 +371,7 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
     // when catching animation finishes, PLAY ally1_name RECRUIT CUTSCENE
     // catch_chance_timer > 0 instead of !is_casting
     if (player_sprite.current_frame == 3 && !registry.players.get(player).ally1_recruited && !is_casting && !is_fish_caught && lakeInfo.id == 1) {
-        createPartyMember(renderer, ally1_name, 15.f, 0.f, 15.f, 0.05f, 1.5f, { manifest, curse, doom, run }, TEXTURE_ASSET_ID::ALLY1_PORTRAIT, TEXTURE_ASSET_ID::ALLY1, ally1_desc);
+        createPartyMember(renderer, ally1PartyMember());
         Dialogue& dialogue = registry.dialogues.emplace(player);
         dialogue.cutscene_id = std::string("ally_1_recruit");
         *current_game_state = GAME_STATE_ID::CUTSCENE;
@@ -370,38 +381,25 @@ bool WorldSystem::step(float elapsed_ms_since_last_update)
     // when catching animation finishes, PLAY ALLY 2 RECRUIT CUTSCENE
     // catch_chance_timer > 0 instead of !is_casting
     if (player_sprite.current_frame == 3 && !registry.players.get(player).ally2_recruited && !is_casting && !is_fish_caught && lakeInfo.id == 2) {
-        createPartyMember(renderer, ally2_name, 10.f, 1.2f, 5.f, 0.05f, 1.5f, { distract, fortress, indestructible, run }, TEXTURE_ASSET_ID::ALLY2_PORTRAIT, TEXTURE_ASSET_ID::ALLY2, ally2_desc);
+        createPartyMember(renderer, ally2PartyMember());
         Dialogue& dialogue = registry.dialogues.emplace(player);
         dialogue.cutscene_id = std::string("ally_2_recruit");
         *current_game_state = GAME_STATE_ID::CUTSCENE;
         setSpriteFrames(player_sprite, 0, 0, 0, 1);
     }
 
-    for (Entity entity : registry.shadowTimers.entities)
-    {
-        // make the fish stop moving when player is in the middle of doing some kind of fishing action
-        Motion& motion = registry.motions.get(entity);
-        if (is_fishing || is_catching || is_showing || is_casting) {
-            motion.velocity = vec2(0, 0);
-        }
-        else {
-            // progress timer
-            ShadowTimer& timer = registry.shadowTimers.get(entity);
-            timer.timer_ms -= elapsed_ms_since_last_update;
-            // stop moving
-            if (timer.timer_ms < FISHSHADOW_DELAY_MS) {
-                motion.velocity = vec2(0, 0);
-            }
-            // reset timer
-            if (timer.timer_ms < 0) {
-                timer.timer_ms = FISHSHADOW_DELAY_MS * 2;
-                motion.velocity = vec2((float)uniform_dist_int(rng) * 200.f, (float)uniform_dist_int(rng) * 100.f);
-            }
-        }
+    // make the fish stop moving when player is in the middle of doing some kind of fishing action,
+    // their timers are paused until the player is done
+    if (is_fishing || is_catching || is_showing || is_casting) {
+        for (Entity entity : registry.shadowTimers.entities)
+            registry.motions.get(entity).velocity = vec2(0, 0);
+    }
+    else {
+        shadow_timers.advance(elapsed_ms_since_last_update);
     }
 
-    if (registry.durabilities.get(fishingRod).num_upgrades >= 7.f &&
-        registry.attacks.get(fishingRod).num_upgrades >= 7.f && registry.players.get(player).ally1_recruited) {
+    if (registry.durabilities.get(fishingRod).num_upgrades >= BOSS_UNLOCK_ROD_UPGRADES &&
+        registry.attacks.get(fishingRod).num_upgrades >= BOSS_UNLOCK_ROD_UPGRADES && registry.players.get(player).ally1_recruited) {
         if (!registry.bosses.size() && !registry.players.get(player).lake1_boss_defeated) {
             Dialogue& dialogue = registry.dialogues.emplace(player);
             dialogue.cutscene_id = std::string("boss_appear");
@@ -429,6 +427,42 @@ void WorldSystem::restart_game()
 
     current_speed = 1.f;
 
+    // the events of the game so far go to its journal, and a save still being written
+    // is the one to continue from
+    save_journal.flush();
+    if (should_load_save)
+        save_service.flush();
+
+    // playtime goes on from the save, a new game starts at 0
+    bool loading = should_load_save;
+    int slot = save_slots.selected();
+    save_slots.start_playtime(loading ? save_slots.info(slot).playtime_s : 0.0);
+
+    // The world was built like this before: put it back in one go
+    WorldSnapshot& snapshot = loading ? loaded_save : new_game;
+    if (snapshot.valid && (!loading || (snapshot.save_slot == slot && snapshot.save_generation == save_generation()))) {
+        should_load_save = false;
+        restore_snapshot(snapshot);
+        // the shadows start somewhere else every game, as when the world is built
+        for (Entity entity : registry.fishShadows.entities)
+            randomize_fish_shadow(entity);
+        if (loading)
+            save_journal.resume(snapshot.journal);
+        else
+            save_journal.start_new_game(slot);
+        return;
+    }
+    bool loaded = false;
+    // until a save is loaded below
+    save_journal.start_new_game(slot);
+
+    // the timers belong to the entities removed below
+    timers.clear();
+    shadow_timers.clear();
+
+    // a new game starts without fish, a loaded one gets the fish of the save
+    fish_collection.clear();
+
     // Remove all entities that we created
     // All that have a motion, we could also iterate over all fish, turtles, ... but that would be more cumbersome
     while (registry.motions.entities.size() > 0)
@@ -468,35 +502,18 @@ void WorldSystem::restart_game()
     // Create random fish shadows
     for (float i = 0; i < MAX_FISHSHADOW; i++) {
         Entity entity = createFishShadow(renderer, { 0,0 });
-        // Setting random initial position and constant velocity
-        Motion& motion = registry.motions.get(entity);
-        float rand_wid_num = uniform_dist(rng);
-        float rand_hei_num = uniform_dist(rng);
-        if (rand_wid_num >= 0.5 && rand_wid_num <= 0.85) {
-            rand_wid_num = 0.85;
-        } else if (rand_wid_num >= 0.15 && rand_wid_num < 0.5) {
-            rand_wid_num = 0.15;
-        }
-        if (rand_hei_num >= 0.5 && rand_hei_num <= 0.85) {
-            rand_hei_num = 0.85;
-        }
-        else if (rand_hei_num >= 0.15 && rand_hei_num < 0.5) {
-            rand_hei_num = 0.15;
-        }
-        motion.position =
-            vec2(rand_wid_num * (window_width_px),
-                rand_hei_num * (window_height_px));
-        motion.velocity = vec2((float)uniform_dist_int(rng) * 100.f, (float)uniform_dist_int(rng) * 50.f);
+        start_shadow_timer(entity);
+        randomize_fish_shadow(entity);
     }
     // starting values
     float posX = (float) window_width_px / 2.f;
     float posY = (float) window_height_px / 2.f;
     int gold = 0;
-    float maxDur = 120.f;
+    float maxDur = ROD_START_DURABILITY;
     float durUpgrades = 0.f;
-    int atk = 10;
+    int atk = ROD_START_ATTACK;
     float atkUpgrades = 0.f;
-    int def = 5;
+    int def = ROD_START_DEFENSE;
     int numOwned1 = 0.f;
     int numOwned2 = 0.f;
 
@@ -516,47 +533,47 @@ void WorldSystem::restart_game()
         float camX = 0.f;
         float camY = 0.f;
         should_load_save = false;
-        std::vector<Fish> fishes;
-        std::vector<FishingLog> fishlog;
         std::vector<Lure> lures;
-        std::ifstream is("../savedata.json");
-        cereal::JSONInputArchive archive(is);
-        archive(cereal::make_nvp("posX", posX), cereal::make_nvp("posY", posY),
-                cereal::make_nvp("cameraX", camX), cereal::make_nvp("cameraY", camY),
-                cereal::make_nvp("gold", gold), cereal::make_nvp("dur_max", maxDur),
-                cereal::make_nvp("attack", atk), cereal::make_nvp("fishes", fishes),
-                cereal::make_nvp("defense", def), cereal::make_nvp("dur_upgrades", durUpgrades),
-                cereal::make_nvp("attack_upgrades", atkUpgrades), cereal::make_nvp("ally1_recruited", ally1Recruit), cereal::make_nvp("ally2_recruited", ally2Recruit),
-                cereal::make_nvp("shiny_tutorial", shinyTutorial), cereal::make_nvp("num_fish_caught_lake1", numFishCaughtLake1), cereal::make_nvp("num_fish_caught_lake2", numFishCaughtLake2),
-                cereal::make_nvp("fishlog", fishlog), cereal::make_nvp("currently_lake_1", currently_lake_1), cereal::make_nvp("lake_id", lakeId),
-                cereal::make_nvp("second_lake_unlocked", second_lake_unlocked),
-                cereal::make_nvp("battle_tutorial_complete", battleTutorialComplete),
-                cereal::make_nvp("basic_tutorial_complete", basicTutorialComplete),
-                cereal::make_nvp("lake1_boss_defeated", lake1BossDefeated),
-                cereal::make_nvp("fishing_tutorial_complete", fishingTutorialComplete),
-                cereal::make_nvp("lake2_entered", lake2Entered));
+        SaveData save;
+        size_t journal_records = 0;
+        if (save_slots.load(slot, save, &journal_records)) {
+            loaded = true;
+            // later events go to the journal of the save, on top of what was replayed
+            JournalSession journal;
+            journal.slot = slot;
+            journal.id = save.journal_id;
+            journal.records = journal_records;
+            save_journal.resume(journal);
+            posX = save.posX;
+            posY = save.posY;
+            camX = save.cameraX;
+            camY = save.cameraY;
+            gold = save.gold;
+            maxDur = save.dur_max;
+            atk = save.attack;
+            def = save.defense;
+            durUpgrades = save.dur_upgrades;
+            atkUpgrades = save.attack_upgrades;
+            ally1Recruit = save.ally1_recruited;
+            ally2Recruit = save.ally2_recruited;
+            shinyTutorial = save.shiny_tutorial;
+            numFishCaughtLake1 = save.num_fish_caught_lake1;
+            numFishCaughtLake2 = save.num_fish_caught_lake2;
+            currently_lake_1 = save.currently_lake_1;
+            lakeId = save.lake_id;
+            second_lake_unlocked = save.second_lake_unlocked;
+            battleTutorialComplete = save.battle_tutorial_complete;
+            basicTutorialComplete = save.basic_tutorial_complete;
+            lake1BossDefeated = save.lake1_boss_defeated;
+            fishingTutorialComplete = save.fishing_tutorial_complete;
+            lake2Entered = save.lake2_entered;
+        }
+        fish_collection = save.collection;
 
         // load camera coordinates
         viewMatrix.mat[2][0] = camX;
         viewMatrix.mat[2][1] = camY;
-
-        // load fishes
-        if (!fishes.empty()) {
-            for (auto & fish : fishes) {
-                FishSpecies species = id_to_fish_species.at(fish.species_id);
-                createFish(renderer, species, fish.lake_id);
-            }
-        }
-
-        // load fishing log
-        if (!fishlog.empty()) {
-            for (auto & entry : fishlog) {
-                auto entity = Entity();
-                FishingLog& log = registry.fishingLog.emplace(entity);
-                log.species_id = entry.species_id;
-                log.lake_id = entry.lake_id;
-            }
-        }
+        previousViewMatrix = viewMatrix;
 
         // load lures
         if (lures.size() >= 2) {
@@ -580,9 +597,9 @@ void WorldSystem::restart_game()
     }
 
     // create lure entities
-    const Lure lures[] = { { "Lure #1", 10, "Catch rate +5%", numOwned1, (int)TEXTURE_ASSET_ID::LURE_1 }, { "Lure #2", 21, "Catch rate +10%", numOwned2, (int)TEXTURE_ASSET_ID::LURE_2 } };
-    createLure(renderer, lures[0], { 5.f });
-    createLure(renderer, lures[1], { 10.f });
+    const Lure lures[] = { { "Lure #1", LURE_PACK_PRICES[0], "Catch rate +5%", numOwned1, (int)TEXTURE_ASSET_ID::LURE_1 }, { "Lure #2", LURE_PACK_PRICES[1], "Catch rate +10%", numOwned2, (int)TEXTURE_ASSET_ID::LURE_2 } };
+    createLure(renderer, lures[0], { LURE_CHARMS[0] });
+    createLure(renderer, lures[1], { LURE_CHARMS[1] });
 
     // Create a new player
     player = createPlayer(renderer, { posX, posY }, gold, lakeId);
@@ -607,19 +624,94 @@ void WorldSystem::restart_game()
     registry.attacks.get(fishingRod).num_upgrades = atkUpgrades;
     randomWaterTile = createWaterTile();
     registry.colors.insert(player, {1, 0.8f, 0.8f});
-    createPartyMember(renderer, mc_name, 10.f, 1.f, 10.f, 0.05f, 1.5f, { reel, release, determination, run }, TEXTURE_ASSET_ID::MC_PORTRAIT, TEXTURE_ASSET_ID::MC_PORTRAIT_1, mc_desc);
+    createPartyMember(renderer, mcPartyMember());
     if (ally1Recruit) {
-        createPartyMember(renderer, ally1_name, 15.f, 0.f, 15.f, 0.05f, 1.5f, { manifest, curse, doom, run }, TEXTURE_ASSET_ID::ALLY1_PORTRAIT, TEXTURE_ASSET_ID::ALLY1, ally1_desc);
+        createPartyMember(renderer, ally1PartyMember());
     }
     if (ally2Recruit) {
-        createPartyMember(renderer, ally2_name, 10.f, 1.2f, 5.f, 0.05f, 1.5f, { distract, fortress, indestructible, run }, TEXTURE_ASSET_ID::ALLY2_PORTRAIT, TEXTURE_ASSET_ID::ALLY2, ally2_desc);
+        createPartyMember(renderer, ally2PartyMember());
     }
 
-    if (durUpgrades >= 7.f && atkUpgrades >= 7.f && ally1Recruit) {
+    if (durUpgrades >= BOSS_UNLOCK_ROD_UPGRADES && atkUpgrades >= BOSS_UNLOCK_ROD_UPGRADES && ally1Recruit) {
         if (!registry.bosses.size() && !lake1BossDefeated) {
             Entity entity = createBossShadow(renderer, { window_width_px - 200.f, window_height_px });
         }
     }
+
+    // a save that couldn't be read isn't remembered, the next load tries it again
+    if (!loading || loaded)
+        take_snapshot(snapshot);
+}
+
+void WorldSystem::randomize_fish_shadow(Entity entity)
+{
+    // Setting random initial position and constant velocity
+    Motion& motion = registry.motions.get(entity);
+    float rand_wid_num = uniform_dist(rng);
+    float rand_hei_num = uniform_dist(rng);
+    if (rand_wid_num >= 0.5 && rand_wid_num <= 0.85) {
+        rand_wid_num = 0.85;
+    } else if (rand_wid_num >= 0.15 && rand_wid_num < 0.5) {
+        rand_wid_num = 0.15;
+    }
+    if (rand_hei_num >= 0.5 && rand_hei_num <= 0.85) {
+        rand_hei_num = 0.85;
+    }
+    else if (rand_hei_num >= 0.15 && rand_hei_num < 0.5) {
+        rand_hei_num = 0.15;
+    }
+    motion.position =
+        vec2(rand_wid_num * (window_width_px),
+            rand_hei_num * (window_height_px));
+    motion.velocity = vec2((float)uniform_dist_int(rng) * 100.f, (float)uniform_dist_int(rng) * 50.f);
+}
+
+void WorldSystem::take_snapshot(WorldSnapshot& snapshot)
+{
+    registry.snapshot(snapshot.components);
+    snapshot.fish_collection = fish_collection;
+    snapshot.timers = timers;
+    snapshot.shadow_timers = shadow_timers;
+    snapshot.player = player;
+    snapshot.fishingRod = fishingRod;
+    snapshot.randomWaterTile = randomWaterTile;
+    snapshot.lakeEntity = lakeEntity;
+    snapshot.catchingBar = catchingBar;
+    snapshot.exclamation = exclamation;
+    snapshot.bgEntity = bgEntity;
+    snapshot.viewMatrix = viewMatrix;
+    snapshot.currently_lake_1 = currently_lake_1;
+    snapshot.second_lake_unlocked = second_lake_unlocked;
+    snapshot.game_state = *current_game_state;
+    snapshot.save_slot = save_slots.selected();
+    snapshot.save_generation = save_generation();
+    snapshot.journal = save_journal.session();
+    snapshot.valid = true;
+}
+
+void WorldSystem::restore_snapshot(const WorldSnapshot& snapshot)
+{
+    registry.restore(snapshot.components);
+    fish_collection = snapshot.fish_collection;
+    // the callbacks only hold this and the entities, which are the same again
+    timers = snapshot.timers;
+    shadow_timers = snapshot.shadow_timers;
+    player = snapshot.player;
+    fishingRod = snapshot.fishingRod;
+    randomWaterTile = snapshot.randomWaterTile;
+    lakeEntity = snapshot.lakeEntity;
+    catchingBar = snapshot.catchingBar;
+    exclamation = snapshot.exclamation;
+    bgEntity = snapshot.bgEntity;
+    viewMatrix = snapshot.viewMatrix;
+    previousViewMatrix = snapshot.viewMatrix;
+    currently_lake_1 = snapshot.currently_lake_1;
+    second_lake_unlocked = snapshot.second_lake_unlocked;
+    // a loaded save opens its tutorials again, a new game keeps the state it was started from
+    if (&snapshot == &loaded_save)
+        *current_game_state = snapshot.game_state;
+    renderer->player = player;
+    sound_system->player = player;
 }
 
 // Compute collisions between entities
@@ -645,20 +737,10 @@ void WorldSystem::handle_collisions()
                 else {
                     *current_game_state = GAME_STATE_ID::TRANSITION;
                 }
-                std::random_device rd;
-                std::mt19937 gen(rd());
                 // probability of getting each enemy type is the same
                 std::uniform_int_distribution<int> choiceDist(0, 2);
-                FishSpecies species = possibleEnemies[choiceDist(gen)];
-                if (species.name == "Turtle") {
-                    createEnemy(renderer, species, { turtle_clap_clap, turtle_shell_collide, turtle_slowing_atk });
-                }
-                else if (species.name == "Narwhal") {
-                    createEnemy(renderer, species, { narwhal_chant, narwhal_chant_intense, narwhal_dream_transfer });
-                }
-                else {
-                    createEnemy(renderer, species, { walrus_flop_flop, walrus_flip_flop });
-                }
+                FishSpecies species = possibleEnemies[choiceDist(rng)];
+                createEnemy(renderer, species, enemySkills(species));
                 rightKeyDown = false;
                 leftKeyDown = false;
                 upKeyDown = false;
@@ -670,7 +752,7 @@ void WorldSystem::handle_collisions()
             }
             else if (registry.bosses.has(entity_other) && !registry.catchingBars.entities.size() && !registry.enemies.entities.size()) {
                 *current_game_state = GAME_STATE_ID::TRANSITION;
-                createEnemy(renderer, boss, { boss_na, boss_heavy, boss_throw_salmon, boss_execution, boss_field, boss_balance });
+                createEnemy(renderer, boss, enemySkills(boss));
                 rightKeyDown = false;
                 leftKeyDown = false;
                 upKeyDown = false;
@@ -756,34 +838,21 @@ FishingResult WorldSystem::select_fish(Entity fishingRod, Entity waterTile)
         }
     }
 
-    // loop through all fish in lake
-    // how to track what lake we are currently in?
     LakeId& lakeInfo = registry.lakes.get(player); // get lake player is currently in
-    float min_timer_ms = -1.f;
+    const LakeFishTables& tables = lake_fish_tables.at(lakeInfo.id);
+    // decrease chance of catching common+uncommon fish if shiny spot is present
+    const FishSelectionTable& table = registry.shinySpots.has(waterTile) ? tables.shiny_spot : tables.normal;
     Fish fish; // set a dummy fish for no catch
-    Lake lake = id_to_lake.at(lakeInfo.id);
-    for (auto& it : lake.id_to_fishable)
-    {
-        int key = it.first;
-        Fishable value = it.second;
-        float probability = value.probability;
-        if (registry.shinySpots.has(waterTile) && value.probability <= UNCOMMON_FISH) {
-            // decrease chance of catching common+uncommon fish if shiny spot is present
-            probability *= 1.5f;
-        }
-
-        std::uniform_real_distribution<float> fish_uniform_real_dist(0, probability * (100.f-buff.charm) / 100.f);
-        // Do stuff
-        float ms_until_catch = fish_uniform_real_dist(rng) * 2000.f;
-        if (min_timer_ms < 0 || ms_until_catch < min_timer_ms)
-        {
-            min_timer_ms = ms_until_catch;
-            fish.species_id = key;
-            tempSpiceID = key;
-            fish_rarity = value.probability; // use original probability here
-        }
-    };
-    return { fish, min_timer_ms };
+    if (table.empty())
+        return { fish, -1.f };
+
+    // charm shortens the wait of every fish alike, so it doesn't change which one bites
+    float charm_scale = std::max(0.f, (100.f - buff.charm) / 100.f);
+    FishSelectionTable::Result result = table.sample(rng);
+    fish.species_id = result.species_id;
+    tempSpiceID = result.species_id;
+    fish_rarity = result.probability; // use original probability here
+    return { fish, result.wait * charm_scale * FISH_WAIT_MS };
 }
 
 void WorldSystem::start_fishing_timer(Entity fishingRod, Entity waterTile)
@@ -795,6 +864,46 @@ void WorldSystem::start_fishing_timer(Entity fishingRod, Entity waterTile)
     timer.timer_ms = fishing_results.ms_until_catch;
     timer.fish = fishing_results.fish;
     is_casting = false;
+
+    // the fish bites once the timer expires
+    timers.schedule(timer.timer_ms, [this, fishingRod]() mutable {
+        if (!registry.fishingTimers.has(fishingRod))
+            return;
+        registry.fishingTimers.remove(fishingRod);
+
+        registry.renderRequests.get(exclamation).is_visible = true;
+        //Mix_PlayChannel(-1, catch_alert, 0);
+        sound_system->playSound(sound_system->catch_alert);
+        setPositionRelativeToPlayer(registry.motions.get(exclamation), vec2(50.f, 80.f), vec2(50.f, 80.f), vec2(0.f, 90.f), vec2(0.f, 110.f));
+        catch_chance_timer = CATCH_CHANCE_MS;
+    });
+}
+
+void WorldSystem::start_remove_entity_timer(Entity entity)
+{
+    float lifetime_ms = registry.removeEntityTimers.get(entity).timer_ms;
+    timers.schedule(lifetime_ms, [entity]() mutable {
+        // may already be gone, e.g. used up by the player
+        if (registry.removeEntityTimers.has(entity))
+            registry.remove_all_components_of(entity);
+    });
+}
+
+void WorldSystem::start_shadow_timer(Entity entity)
+{
+    // the shadow stops FISHSHADOW_DELAY_MS before it picks a new direction
+    float retarget_ms = registry.shadowTimers.get(entity).timer_ms;
+    shadow_timers.schedule(retarget_ms - FISHSHADOW_DELAY_MS, [entity]() mutable {
+        if (registry.motions.has(entity))
+            registry.motions.get(entity).velocity = vec2(0, 0);
+    });
+    shadow_timers.schedule(retarget_ms, [this, entity]() mutable {
+        if (!registry.shadowTimers.has(entity))
+            return;
+        registry.motions.get(entity).velocity = vec2((float)uniform_dist_int(rng) * 200.f, (float)uniform_dist_int(rng) * 100.f);
+        registry.shadowTimers.get(entity).timer_ms = FISHSHADOW_DELAY_MS * 2;
+        start_shadow_timer(entity);
+    });
 }
 
 
@@ -866,7 +975,7 @@ void WorldSystem::on_key(int key, int, int action, int mod)
         registry.renderRequests.get(catchingBar).is_visible = true;
 
         struct CatchingBar& cb = registry.catchingBars.get(catchingBar);
-        cb.filled += 0.05f;
+        cb.filled += CATCHING_BAR_PER_PRESS;
         cb.filled = min(cb.filled, 1.f);
         if (cb.filled == 1.f) {
             // caught the fish once the bar is filled
@@ -964,6 +1073,10 @@ void WorldSystem::on_key(int key, int, int action, int mod)
             debugging.in_debug_mode = true;
     }
 
+    // Performance overlay (frame times, per system timings, GL counters, ECS pools, memory)
+    if (key == GLFW_KEY_F3 && action == GLFW_PRESS)
+        debugging.show_perf_overlay = !debugging.show_perf_overlay;
+
     if (key == GLFW_KEY_M && action == GLFW_PRESS) {
         if (*current_game_state == GAME_STATE_ID::INVENTORY) {
             *current_game_state = GAME_STATE_ID::WORLD;
@@ -1036,7 +1149,8 @@ void WorldSystem::on_key(int key, int, int action, int mod)
             FishingResult fishRes = select_fish(fishingRod, randomWaterTile);
             FishSpecies species = id_to_fish_species.at(fishRes.fish.species_id);
             LakeId& lakeInfo = registry.lakes.get(player);
-            caughtFish = createFish(renderer, species, lakeInfo.id);
+            fish_collection.record_catch(species.id, lakeInfo.id);
+            save_journal.record(JournalRecord::caught(species.id, lakeInfo.id, false));
         }
     }
 
@@ -1085,12 +1199,30 @@ void WorldSystem::on_key(int key, int, int action, int mod)
         Player& player_info = registry.players.get(player);
         if (!player_info.ally1_recruited) {
             player_info.ally1_recruited = true;
+            save_journal.record(JournalRecord::recruited(1));
             createPartyMember(renderer, ally2_name, 14.f, 0, 5.f, 0.05f, 1.5f, { distract, fortress, indestructible, run }, TEXTURE_ASSET_ID::ALLY2_PORTRAIT, TEXTURE_ASSET_ID::ALLY2, ally2_desc);
         }
     }
 }
 
 
+void WorldSystem::handle_input(const InputEvent& event)
+{
+    switch (event.type) {
+        case InputEvent::KEY:
+            on_key(event.code, 0, event.action, event.mods);
+            break;
+        case InputEvent::MOUSE_BUTTON:
+            on_mouse_button(event.code, event.action, event.mods);
+            break;
+        case InputEvent::MOUSE_MOVE:
+            on_mouse_move({ event.x, event.y });
+            break;
+        default:
+            break;
+    }
+}
+
 void WorldSystem::on_mouse_move(vec2 mouse_position)
 {
 	(vec2) mouse_position; // dummy to avoid compiler warning
@@ -1117,7 +1249,7 @@ void WorldSystem::on_mouse_button(int button, int action, int mods)
         registry.renderRequests.get(catchingBar).is_visible = true;
 
 		struct CatchingBar& cb = registry.catchingBars.get(catchingBar);
-		cb.filled += 0.05f;
+		cb.filled += CATCHING_BAR_PER_PRESS;
 		cb.filled = min(cb.filled, 1.f);
 		if (cb.filled == 1.f) {
             // caught the fish once the bar is filled
@@ -1217,6 +1349,7 @@ void WorldSystem::catch_fish(int fish_id, bool from_battle) {
         else if (!from_battle && lakeInfo.id == 2) {
             player_info.num_fish_caught_lake2++;
         }
+        save_journal.record(JournalRecord::caught(species.id, lakeInfo.id, !from_battle));
 
         if (species.id == boss.id) {
             Dialogue& dialogue = registry.dialogues.emplace(player);
@@ -9,6 +9,14 @@
 
 #include "sound_system.hpp"
 #include "render_system.hpp"
+#include "timer_wheel.hpp"
+#include "fish_selection.hpp"
+#include "fishing_rules.hpp"
+#include "rng.hpp"
+#include "input_queue.hpp"
+#include "tiny_ecs_registry.hpp"
+#include "fish_collection.hpp"
+#include "save_journal.hpp"
 
 // Container for all our entities and game logic. Individual rendering / update is
 // deferred to the relative update() methods
@@ -35,11 +43,14 @@ public:
 	// Should the game be over ?
 	bool is_over() const;
 
-    // restart level
+    // restart level, or load the save if should_load_save is set
     void restart_game();
 
     bool should_load_save = false;
 
+    // Input queued by the GLFW callbacks or played back from a recording
+    void handle_input(const InputEvent& event);
+
 private:
 	// Input callback functions
 	void on_key(int key, int, int action, int mod);
@@ -54,6 +65,42 @@ private:
 	void catch_fish(int fish_id, bool from_battle = false);
 	void start_fishing_timer(Entity fishingRod, Entity shinySpot);
 	FishingResult select_fish(Entity fishingRod, Entity shinySpot);
+	// Removes the entity once its RemoveEntityTimer runs out
+	void start_remove_entity_timer(Entity entity);
+	// Stops and re-targets a fish shadow on the schedule of its ShadowTimer
+	void start_shadow_timer(Entity entity);
+	// Random position near the edge of the lake and random direction for a fish shadow
+	void randomize_fish_shadow(Entity entity);
+
+	// Everything restart_game() sets up. Restarting, and loading a save loaded before, put
+	// it back instead of building the world again.
+	struct WorldSnapshot
+	{
+		bool valid = false;
+		// the slot and save_generation() of the save it was built from
+		int save_slot = 0;
+		uint64_t save_generation = 0;
+		JournalSession journal;
+		RegistrySnapshot components;
+		FishCollection fish_collection;
+		TimerWheel timers;
+		TimerWheel shadow_timers;
+		Entity player;
+		Entity fishingRod;
+		Entity randomWaterTile;
+		Entity lakeEntity;
+		Entity catchingBar;
+		Entity exclamation;
+		Entity bgEntity;
+		Transform viewMatrix;
+		bool currently_lake_1 = true;
+		bool second_lake_unlocked = true;
+		GAME_STATE_ID game_state = GAME_STATE_ID::WORLD;
+	};
+	void take_snapshot(WorldSnapshot& snapshot);
+	void restore_snapshot(const WorldSnapshot& snapshot);
+	WorldSnapshot new_game;
+	WorldSnapshot loaded_save;
 
 	// OpenGL window handle
 	GLFWwindow *window;
@@ -64,6 +111,11 @@ private:
 	RenderSystem *renderer;
 	SoundSystem* sound_system;
 	Entity player;
+
+	// Timed events of the world, only the ones that expire are touched each step
+	TimerWheel timers;
+	// Timers of the fish shadows, they don't advance while the player is fishing
+	TimerWheel shadow_timers;
 	Entity caughtFish;
 	Entity map;
 	Entity fishingRod;
@@ -79,12 +131,15 @@ private:
 	// determines mini game
 	float fish_rarity;
 
+	// which fish bites and when, per lake id, built when the lakes are loaded in init()
+	std::unordered_map<int, LakeFishTables> lake_fish_tables;
+
 	// constants TODO M1: where are constants supposed to go?
 	// Lake lake1 = Lake({{1, Fishable(10)}, {2, Fishable(20)}});
 	// Lake ALL_LAKES[1] = {lake1};
 
 	// C++ random number generator
-	std::default_random_engine rng;
+	RngStream rng;
 	std::uniform_real_distribution<float> uniform_dist; // number between 0..1
 	std::uniform_real_distribution<float> uniform_dist_timer{ 1.f, 3.f }; // number between 1..3
 	std::uniform_int_distribution<int> uniform_dist_int{ -1, 1 }; // number between -1, 0, 1
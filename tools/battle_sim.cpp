@@ -0,0 +1,277 @@
+// Plays battles against the enemies of the lakes without a window, sound or GL, to balance
+// them against the rod upgrades. Every battle runs on the game's BattleCore with a fresh
+// rod and party, the party picks its skills with one of the policies below, and the
+// battles are spread over the job system.
+// Prints the win rate and the rounds it took to win per enemy, rod upgrade level and policy.
+//
+// usage: battle_sim [--battles=N] [--max-upgrade=N] [--upgrade-step=N] [--party=1..3]
+//                   [--workers=N] [--seed=N]
+
+// stlib
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// internal
+#include "battle_core.hpp"
+#include "fishing_rules.hpp"
+#include "job_system.hpp"
+#include "parallel_for.hpp"
+#include "rng.hpp"
+
+namespace
+{
+	// a battle still going after this many rounds counts as lost
+	const int MAX_ROUNDS = 100;
+	const size_t BATTLE_CHUNK = 500;
+
+	// Picks the skill allMembers[currMemberIndex] uses, "Run" is never picked
+	typedef int (*Policy)(const BattleCore& core, RngStream& rng);
+
+	bool is_run(const Skill& skill)
+	{
+		return skill.skill_type == SKILL_TYPE::NONE;
+	}
+
+	// strongest attack of the member
+	int attack_policy(const BattleCore& core, RngStream& rng)
+	{
+		const std::vector<Skill>& skills = core.allMembers[core.currMemberIndex].skills;
+		int best = -1;
+		for (int i = 0; i < (int)skills.size(); i++) {
+			if (skills[i].skill_type == SKILL_TYPE::ATK && (best == -1 || skills[i].skill_scale > skills[best].skill_scale))
+				best = i;
+		}
+		return best == -1 ? 0 : best;
+	}
+
+	// any skill, like someone who doesn't read the descriptions
+	int random_policy(const BattleCore& core, RngStream& rng)
+	{
+		const std::vector<Skill>& skills = core.allMembers[core.currMemberIndex].skills;
+		std::vector<int> usable;
+		for (int i = 0; i < (int)skills.size(); i++) {
+			if (!is_run(skills[i]))
+				usable.push_back(i);
+		}
+		std::uniform_int_distribution<size_t> dist(0, usable.size() - 1);
+		return usable[dist(rng)];
+	}
+
+	bool effect_active(const FixedVector<CurrEffect, MAX_EFFECTS>& effects, const std::string& skill_name)
+	{
+		for (const CurrEffect& effect : effects) {
+			if (effect.skill_name == skill_name)
+				return true;
+		}
+		return false;
+	}
+
+	// heals the rod when it's low, keeps the buffs and debuffs up and attacks otherwise
+	int smart_policy(const BattleCore& core, RngStream& rng)
+	{
+		const PartyMember& member = core.allMembers[core.currMemberIndex];
+		const std::vector<Skill>& skills = member.skills;
+		for (int i = 0; i < (int)skills.size(); i++) {
+			if (skills[i].skill_type == SKILL_TYPE::HEAL && core.currHealth < 0.4f * core.maxHealth)
+				return i;
+		}
+		for (int i = 0; i < (int)skills.size(); i++) {
+			const Skill& skill = skills[i];
+			switch (skill.skill_effect.type) {
+				case EFFECT_TYPE::BUFF_ATK:
+					if (!effect_active(member.currEffects, skill.skill_name))
+						return i;
+					break;
+				case EFFECT_TYPE::BUFF_DEF:
+					if (!effect_active(core.rodEffects, skill.skill_name))
+						return i;
+					break;
+				case EFFECT_TYPE::DEBUFF_ATK:
+				case EFFECT_TYPE::DEBUFF_ALL:
+					if (!effect_active(core.enemy->currEffects, skill.skill_name))
+						return i;
+					break;
+				default:
+					break;
+			}
+		}
+		return attack_policy(core, rng);
+	}
+
+	struct NamedPolicy {
+		const char* name;
+		Policy policy;
+	};
+	const NamedPolicy policies[] = { { "random", random_policy }, { "attack", attack_policy }, { "smart", smart_policy } };
+
+	struct Options {
+		size_t battles = 20000;
+		int max_upgrade = 10;
+		int upgrade_step = 1;
+		int party = 2;
+		int workers = -1;
+		unsigned seed = 1;
+	};
+
+	struct Result {
+		long long wins = 0;
+		long long rounds_to_win = 0;
+		double durability_left = 0.0; // share of the rod's durability left after the wins
+
+		void add(const Result& other)
+		{
+			wins += other.wins;
+			rounds_to_win += other.rounds_to_win;
+			durability_left += other.durability_left;
+		}
+	};
+
+	// One battle from the first round to the end, the same turns BattleSystem goes through
+	void battle(const FishSpecies& species, const std::vector<PartyMember>& party, int upgrades, Policy policy, RngStream& rng, Result& result)
+	{
+		Durability durability;
+		durability.max = ROD_START_DURABILITY + upgrades * ROD_DURABILITY_PER_UPGRADE;
+		durability.current = durability.max;
+		Attack attack;
+		attack.damage = ROD_START_ATTACK + upgrades * ROD_ATTACK_PER_UPGRADE;
+		Defense defense;
+		defense.value = ROD_START_DEFENSE;
+		Enemy enemy;
+		enemy.species = species;
+		enemy.skills = enemySkills(species);
+
+		BattleCore core;
+		core.loadEnemy(&enemy);
+		core.loadRod(&durability, attack, defense);
+		core.loadParty(party);
+
+		BattleCore::Turn turn = core.roundBeginTurn();
+		while (core.roundCounter <= MAX_ROUNDS) {
+			switch (turn) {
+				case BattleCore::Turn::PLAYER:
+					core.playerAction(policy(core, rng), rng);
+					turn = core.nextTurn(core.allMembers[core.currMemberIndex].actionIndex);
+					break;
+				case BattleCore::Turn::ENEMY:
+					core.enemyAction(rng);
+					core.enemyActed = true;
+					turn = core.nextTurn(enemy.actionIndex);
+					break;
+				case BattleCore::Turn::ROUND_OVER:
+					turn = core.roundBeginTurn();
+					break;
+				case BattleCore::Turn::ENEMY_DEFEATED:
+					result.wins++;
+					result.rounds_to_win += core.roundCounter;
+					result.durability_left += durability.current / durability.max;
+					return;
+				case BattleCore::Turn::PLAYER_DEFEATED:
+					return;
+			}
+		}
+	}
+
+	// options.battles battles against one enemy, split into chunks with their own generator
+	Result simulate(const Options& options, const FishSpecies& species, const std::vector<PartyMember>& party, int upgrades, Policy policy, unsigned scenario)
+	{
+		size_t chunks = (options.battles + BATTLE_CHUNK - 1) / BATTLE_CHUNK;
+		std::vector<Result> chunk_results(chunks);
+		parallel_for(options.battles, BATTLE_CHUNK, [&](size_t begin, size_t end) {
+			// without workers everything comes in as one range, the streams still go by
+			// chunk so the results don't depend on the thread count
+			RngStream rng;
+			for (size_t i = begin; i < end; i++) {
+				if (i % BATTLE_CHUNK == 0)
+					rng = rng_service.stream("battle_sim", ((uint64_t)scenario << 32) | (i / BATTLE_CHUNK));
+				battle(species, party, upgrades, policy, rng, chunk_results[i / BATTLE_CHUNK]);
+			}
+		});
+		Result total;
+		for (const Result& result : chunk_results)
+			total.add(result);
+		return total;
+	}
+
+	// Returns the value of "--name=value" if arg starts with prefix, nullptr otherwise
+	const char* option_value(const char* arg, const char* prefix)
+	{
+		size_t length = strlen(prefix);
+		return strncmp(arg, prefix, length) == 0 ? arg + length : nullptr;
+	}
+
+	bool parse(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; i++) {
+			const char* arg = argv[i];
+			const char* value = nullptr;
+			if ((value = option_value(arg, "--battles=")) != nullptr)
+				options.battles = (size_t)atoll(value);
+			else if ((value = option_value(arg, "--max-upgrade=")) != nullptr)
+				options.max_upgrade = atoi(value);
+			else if ((value = option_value(arg, "--upgrade-step=")) != nullptr)
+				options.upgrade_step = atoi(value);
+			else if ((value = option_value(arg, "--party=")) != nullptr)
+				options.party = atoi(value);
+			else if ((value = option_value(arg, "--workers=")) != nullptr)
+				options.workers = atoi(value);
+			else if ((value = option_value(arg, "--seed=")) != nullptr)
+				options.seed = (unsigned)strtoul(value, nullptr, 10);
+			else {
+				fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+		if (options.party < 1 || options.party > 3 || options.upgrade_step < 1) {
+			fprintf(stderr, "--party has to be 1 to 3 and --upgrade-step at least 1\n");
+			return false;
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parse(argc, argv, options))
+		return EXIT_FAILURE;
+
+	// members join in this order in the game
+	std::vector<PartyMember> party = { mcPartyMember(), ally1PartyMember(), ally2PartyMember() };
+	party.resize(options.party);
+	const FishSpecies enemies[] = { sleepyNarwhal, turtle, walrus, boss };
+
+	rng_service.seed(options.seed);
+	job_system.start(options.workers);
+	printf("%zu battles per row, party of %d, %d threads, seed %u\n", options.battles, options.party, job_system.worker_count() + 1, options.seed);
+	printf("rod: %.0f durability, %d attack, %d defense, +%.0f durability and +%d attack per upgrade\n\n",
+		ROD_START_DURABILITY, ROD_START_ATTACK, ROD_START_DEFENSE, ROD_DURABILITY_PER_UPGRADE, ROD_ATTACK_PER_UPGRADE);
+
+	unsigned scenario = 0;
+	for (const FishSpecies& species : enemies) {
+		printf("== %s (%.0f health, %.0f attack, %.0f defense, %.0f speed)\n", species.name.c_str(), species.health, species.attack, species.defense, species.speed);
+		printf("%-9s", "upgrades");
+		for (const NamedPolicy& policy : policies)
+			printf(" | %-6s %6s %6s %5s", policy.name, "win", "rounds", "rod");
+		printf("\n");
+		for (int upgrades = 0; upgrades <= options.max_upgrade; upgrades += options.upgrade_step) {
+			printf("%-9d", upgrades);
+			for (const NamedPolicy& policy : policies) {
+				Result result = simulate(options, species, party, upgrades, policy.policy, scenario++);
+				if (result.wins == 0) {
+					printf(" | %-6s %5.1f%% %6s %5s", "", 0.0, "-", "-");
+					continue;
+				}
+				printf(" | %-6s %5.1f%% %6.2f %4.0f%%", "", 100.0 * result.wins / options.battles,
+					(double)result.rounds_to_win / result.wins, 100.0 * result.durability_left / result.wins);
+			}
+			printf("\n");
+		}
+		printf("\n");
+	}
+
+	job_system.stop();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,382 @@
+// Monte Carlo simulation of the fishing economy, without a window, sound or GL.
+// Plays the fishing loop of WorldSystem (cast, wait for a bite, react to the exclamation
+// mark, fill the catching bar, look at the fish, sell it) with the rules of
+// fishing_rules.hpp and the fish tables of every lake, spread over the job system.
+// Prints
+//  - how often each species bites per lake, with and without a shiny spot
+//  - the gold earned per hour of fishing per lake and lure
+//  - the time from a new game until the lake 1 boss shows up, per lure
+//
+// usage: fishing_sim [--casts=N] [--players=N] [--shiny-rate=F] [--reaction-ms=MS]
+//                    [--reaction-spread=F] [--presses-per-second=F] [--press-spread=F]
+//                    [--workers=N] [--seed=N]
+
+// stlib
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+// internal
+#include "fish_selection.hpp"
+#include "fishing_rules.hpp"
+#include "job_system.hpp"
+#include "parallel_for.hpp"
+#include "rng.hpp"
+
+namespace
+{
+	// frames 0 to 6 of the cast animation at 0.1 s a frame, the bite timer starts on frame 6
+	const float CAST_MS = 600.f;
+	// 4 frames at 0.12 s
+	const float CATCH_ANIMATION_MS = 480.f;
+	// a new game that hasn't unlocked the boss after this long is given up on
+	const double GIVE_UP_MS = 100.0 * 3600.0 * 1000.0;
+
+	const size_t CAST_CHUNK = 10000;
+	const size_t PLAYER_CHUNK = 16;
+
+	// How the simulated player plays
+	struct Behaviour {
+		// share of the casts that land on a shiny spot
+		float shiny_rate = 0.2f;
+		// Time to press F once the exclamation mark shows up and how fast F is pressed to fill
+		// the catching bar, both log-normal around their median with the spread as the sigma
+		// of the log. The tails are what cross the limits: a reaction slower than
+		// CATCH_CHANCE_MS misses the fish, pressing too slowly for the drain lets it escape.
+		float reaction_ms = 400.f;
+		float reaction_spread = 0.6f;
+		float presses_per_second = 6.f;
+		float press_spread = 0.4f;
+		// lure bought and used, -1 for none
+		int lure = -1;
+	};
+
+	struct Options {
+		size_t casts = 1000000;
+		size_t players = 2000;
+		int workers = -1;
+		unsigned seed = 1;
+		Behaviour behaviour;
+	};
+
+	struct Angler {
+		int lake_id = 1;
+		int gold = 0;
+		int lures_owned = 0;
+		int dur_upgrades = 0;
+		int atk_upgrades = 0;
+		bool ally_recruited = true;
+		double time_ms = 0.0;
+	};
+
+	struct Stats {
+		long long casts = 0;
+		long long catches = 0;
+		long long missed = 0; // exclamation mark went away before F was pressed
+		long long escaped = 0; // catching bar ran empty
+		long long gold_earned = 0;
+		long long gold_on_lures = 0;
+		double time_ms = 0.0;
+		// bites per species id, [0] without and [1] with a shiny spot
+		std::vector<long long> bites[2];
+
+		Stats()
+		{
+			int max_id = 0;
+			for (auto& it : id_to_fish_species)
+				max_id = std::max(max_id, it.first);
+			bites[0].assign(max_id + 1, 0);
+			bites[1].assign(max_id + 1, 0);
+		}
+
+		void add(const Stats& other)
+		{
+			casts += other.casts;
+			catches += other.catches;
+			missed += other.missed;
+			escaped += other.escaped;
+			gold_earned += other.gold_earned;
+			gold_on_lures += other.gold_on_lures;
+			time_ms += other.time_ms;
+			for (int s = 0; s < 2; s++) {
+				for (size_t i = 0; i < bites[s].size(); i++)
+					bites[s][i] += other.bites[s][i];
+			}
+		}
+	};
+
+	// No spread always gives the median
+	float log_normal(float median, float spread, RngStream& rng)
+	{
+		if (spread <= 0.f)
+			return median;
+		std::lognormal_distribution<float> dist(std::log(median), spread);
+		return dist(rng);
+	}
+
+	// One cast, same steps and timings as WorldSystem::step/on_key
+	void cast(Angler& angler, const LakeFishTables& tables, const Behaviour& behaviour, RngStream& rng, Stats& stats)
+	{
+		std::uniform_real_distribution<float> unit_dist(0.f, 1.f);
+		stats.casts++;
+
+		if (behaviour.lure >= 0 && angler.lures_owned == 0 && angler.gold >= LURE_PACK_PRICES[behaviour.lure]) {
+			angler.gold -= LURE_PACK_PRICES[behaviour.lure];
+			angler.lures_owned += LURE_PACK_SIZE;
+			stats.gold_on_lures += LURE_PACK_PRICES[behaviour.lure];
+		}
+		float charm = behaviour.lure >= 0 && angler.lures_owned > 0 ? LURE_CHARMS[behaviour.lure] : 0.f;
+
+		bool shiny_spot = unit_dist(rng) < behaviour.shiny_rate;
+		const FishSelectionTable& table = shiny_spot ? tables.shiny_spot : tables.normal;
+		FishSelectionTable::Result bite = table.sample(rng);
+		angler.time_ms += CAST_MS + bite.wait * std::max(0.f, (100.f - charm) / 100.f) * FISH_WAIT_MS;
+		if (bite.species_id < 0)
+			return;
+		stats.bites[shiny_spot ? 1 : 0][bite.species_id]++;
+
+		float reaction_ms = log_normal(behaviour.reaction_ms, behaviour.reaction_spread, rng);
+		if (reaction_ms >= CATCH_CHANCE_MS) {
+			angler.time_ms += CATCH_CHANCE_MS;
+			stats.missed++;
+			return;
+		}
+		angler.time_ms += reaction_ms;
+
+		// the first fish of a lake brings in the ally instead of being kept
+		if (!angler.ally_recruited) {
+			angler.ally_recruited = true;
+			angler.time_ms += CATCH_ANIMATION_MS;
+			return;
+		}
+
+		if (bite.probability != COMMON_FISH) {
+			float presses_per_second = log_normal(behaviour.presses_per_second, behaviour.press_spread, rng);
+			float fill_per_second = presses_per_second * CATCHING_BAR_PER_PRESS - 1000.f / CATCHING_BAR_DRAIN_MS;
+			if (fill_per_second <= 0.f) {
+				// whatever was pressed, the bar runs down to the escape mark
+				angler.time_ms += (CATCHING_BAR_START - CATCHING_BAR_ESCAPE) * CATCHING_BAR_DRAIN_MS;
+				stats.escaped++;
+				return;
+			}
+			angler.time_ms += (1.f - CATCHING_BAR_START) / fill_per_second * 1000.f;
+		}
+
+		const FishSpecies& species = id_to_fish_species.at(bite.species_id);
+		angler.gold += species.price;
+		angler.time_ms += CATCH_ANIMATION_MS + SHOW_FISH_MS;
+		if (angler.lures_owned > 0)
+			angler.lures_owned--;
+		stats.catches++;
+		stats.gold_earned += species.price;
+	}
+
+	// Spends the gold on the cheapest rod upgrade still needed for the boss
+	void buy_upgrades(Angler& angler)
+	{
+		bool bought = true;
+		while (bought) {
+			bought = false;
+			if (angler.dur_upgrades < BOSS_UNLOCK_ROD_UPGRADES && angler.gold >= ROD_DURABILITY_UPGRADE_PRICE) {
+				angler.gold -= ROD_DURABILITY_UPGRADE_PRICE;
+				angler.dur_upgrades++;
+				bought = true;
+			}
+			if (angler.atk_upgrades < BOSS_UNLOCK_ROD_UPGRADES && angler.gold >= ROD_ATTACK_UPGRADE_PRICE) {
+				angler.gold -= ROD_ATTACK_UPGRADE_PRICE;
+				angler.atk_upgrades++;
+				bought = true;
+			}
+		}
+	}
+
+	bool boss_unlocked(const Angler& angler)
+	{
+		return angler.ally_recruited && angler.dur_upgrades >= BOSS_UNLOCK_ROD_UPGRADES && angler.atk_upgrades >= BOSS_UNLOCK_ROD_UPGRADES;
+	}
+
+	RngStream chunk_rng(unsigned scenario, size_t chunk)
+	{
+		return rng_service.stream("fishing_sim", ((uint64_t)scenario << 32) | chunk);
+	}
+
+	// Fishes options.casts times in a lake, split into chunks that each have their own angler
+	Stats fish_for_gold(const Options& options, const LakeFishTables& tables, int lake_id, const Behaviour& behaviour, unsigned scenario)
+	{
+		size_t chunks = (options.casts + CAST_CHUNK - 1) / CAST_CHUNK;
+		std::vector<Stats> chunk_stats(chunks);
+		parallel_for(options.casts, CAST_CHUNK, [&](size_t begin, size_t end) {
+			// without workers everything comes in as one range, it's still split by chunk
+			// so the results don't depend on the thread count
+			for (size_t chunk_begin = begin; chunk_begin < end; chunk_begin += CAST_CHUNK) {
+				size_t chunk_end = std::min(chunk_begin + CAST_CHUNK, end);
+				RngStream rng = chunk_rng(scenario, chunk_begin / CAST_CHUNK);
+				Stats& stats = chunk_stats[chunk_begin / CAST_CHUNK];
+				Angler angler;
+				angler.lake_id = lake_id;
+				for (size_t i = chunk_begin; i < chunk_end; i++)
+					cast(angler, tables, behaviour, rng, stats);
+				stats.time_ms = angler.time_ms;
+			}
+		});
+		Stats total;
+		for (const Stats& stats : chunk_stats)
+			total.add(stats);
+		return total;
+	}
+
+	// Minutes of fishing every player needed from a new game to the lake 1 boss, sorted
+	std::vector<double> time_to_boss(const Options& options, const LakeFishTables& tables, const Behaviour& behaviour, unsigned scenario)
+	{
+		std::vector<double> minutes(options.players);
+		parallel_for(options.players, PLAYER_CHUNK, [&](size_t begin, size_t end) {
+			RngStream rng;
+			Stats stats;
+			for (size_t i = begin; i < end; i++) {
+				if (i % PLAYER_CHUNK == 0)
+					rng = chunk_rng(scenario, i / PLAYER_CHUNK);
+				Angler angler;
+				angler.ally_recruited = false;
+				while (!boss_unlocked(angler) && angler.time_ms < GIVE_UP_MS) {
+					cast(angler, tables, behaviour, rng, stats);
+					buy_upgrades(angler);
+				}
+				minutes[i] = boss_unlocked(angler) ? angler.time_ms / 60000.0 : -1.0;
+			}
+		});
+		std::sort(minutes.begin(), minutes.end());
+		return minutes;
+	}
+
+	const char* lure_name(int lure)
+	{
+		static const char* names[LURE_TYPES + 1] = { "none", "lure #1", "lure #2" };
+		return names[lure + 1];
+	}
+
+	// Returns the value of "--name=value" if arg starts with prefix, nullptr otherwise
+	const char* option_value(const char* arg, const char* prefix)
+	{
+		size_t length = strlen(prefix);
+		return strncmp(arg, prefix, length) == 0 ? arg + length : nullptr;
+	}
+
+	bool parse(int argc, char* argv[], Options& options)
+	{
+		for (int i = 1; i < argc; i++) {
+			const char* arg = argv[i];
+			const char* value = nullptr;
+			if ((value = option_value(arg, "--casts=")) != nullptr)
+				options.casts = (size_t)atoll(value);
+			else if ((value = option_value(arg, "--players=")) != nullptr)
+				options.players = (size_t)atoll(value);
+			else if ((value = option_value(arg, "--shiny-rate=")) != nullptr)
+				options.behaviour.shiny_rate = (float)atof(value);
+			else if ((value = option_value(arg, "--reaction-ms=")) != nullptr)
+				options.behaviour.reaction_ms = (float)atof(value);
+			else if ((value = option_value(arg, "--reaction-spread=")) != nullptr)
+				options.behaviour.reaction_spread = (float)atof(value);
+			else if ((value = option_value(arg, "--presses-per-second=")) != nullptr)
+				options.behaviour.presses_per_second = (float)atof(value);
+			else if ((value = option_value(arg, "--press-spread=")) != nullptr)
+				options.behaviour.press_spread = (float)atof(value);
+			else if ((value = option_value(arg, "--workers=")) != nullptr)
+				options.workers = atoi(value);
+			else if ((value = option_value(arg, "--seed=")) != nullptr)
+				options.seed = (unsigned)strtoul(value, nullptr, 10);
+			else {
+				fprintf(stderr, "Unknown option %s\n", arg);
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	Options options;
+	if (!parse(argc, argv, options))
+		return EXIT_FAILURE;
+
+	std::unordered_map<int, LakeFishTables> lake_fish_tables = build_lake_fish_tables();
+	std::vector<int> lake_ids;
+	for (auto& it : lake_fish_tables)
+		lake_ids.push_back(it.first);
+	std::sort(lake_ids.begin(), lake_ids.end());
+
+	rng_service.seed(options.seed);
+	job_system.start(options.workers);
+	printf("%zu casts per scenario, %zu players to the boss, %d threads, seed %u\n", options.casts, options.players, job_system.worker_count() + 1, options.seed);
+	printf("shiny spot on %.0f%% of the casts, %.0f ms median reaction (spread %.2f), %.1f median presses per second (spread %.2f)\n\n",
+		options.behaviour.shiny_rate * 100.f, options.behaviour.reaction_ms, options.behaviour.reaction_spread,
+		options.behaviour.presses_per_second, options.behaviour.press_spread);
+
+	unsigned scenario = 0;
+	for (int lake_id : lake_ids) {
+		const LakeFishTables& tables = lake_fish_tables.at(lake_id);
+		std::vector<Stats> by_lure;
+		for (int lure = -1; lure < LURE_TYPES; lure++) {
+			Behaviour behaviour = options.behaviour;
+			behaviour.lure = lure;
+			by_lure.push_back(fish_for_gold(options, tables, lake_id, behaviour, scenario++));
+		}
+
+		printf("== lake %d\n", lake_id);
+		printf("%-10s %10s %10s %8s %8s %12s\n", "lure", "casts/h", "catches/h", "missed", "escaped", "net gold/h");
+		for (int lure = -1; lure < LURE_TYPES; lure++) {
+			const Stats& stats = by_lure[lure + 1];
+			double hours = stats.time_ms / 3600000.0;
+			printf("%-10s %10.0f %10.0f %7.1f%% %7.1f%% %12.0f\n", lure_name(lure), stats.casts / hours, stats.catches / hours,
+				100.0 * stats.missed / stats.casts, 100.0 * stats.escaped / stats.casts, (stats.gold_earned - stats.gold_on_lures) / hours);
+		}
+
+		// lures only change how long the bites take, so every run counts towards the species
+		Stats all;
+		for (const Stats& stats : by_lure)
+			all.add(stats);
+		long long bites[2] = { 0, 0 };
+		for (int s = 0; s < 2; s++) {
+			for (long long count : all.bites[s])
+				bites[s] += count;
+		}
+		printf("\n%-20s %6s %10s %10s\n", "species", "price", "bites", "shiny spot");
+		for (size_t id = 0; id < all.bites[0].size(); id++) {
+			if (all.bites[0][id] == 0 && all.bites[1][id] == 0)
+				continue;
+			const FishSpecies& species = id_to_fish_species.at((int)id);
+			printf("%-20s %6d %9.3f%% %9.3f%%\n", species.name.c_str(), species.price,
+				bites[0] > 0 ? 100.0 * all.bites[0][id] / bites[0] : 0.0, bites[1] > 0 ? 100.0 * all.bites[1][id] / bites[1] : 0.0);
+		}
+		printf("\n");
+	}
+
+	printf("== new game to lake 1 boss (%d durability and attack upgrades)\n", (int)BOSS_UNLOCK_ROD_UPGRADES);
+	printf("%-10s %10s %10s %10s %10s\n", "lure", "mean min", "p50 min", "p90 min", "gave up");
+	const LakeFishTables& lake1_tables = lake_fish_tables.at(1);
+	for (int lure = -1; lure < LURE_TYPES; lure++) {
+		Behaviour behaviour = options.behaviour;
+		behaviour.lure = lure;
+		std::vector<double> minutes = time_to_boss(options, lake1_tables, behaviour, scenario++);
+		// players that gave up are sorted to the front
+		auto unlocked = std::upper_bound(minutes.begin(), minutes.end(), -1.0);
+		size_t gave_up = unlocked - minutes.begin();
+		size_t count = minutes.end() - unlocked;
+		double sum = 0.0;
+		for (auto it = unlocked; it != minutes.end(); ++it)
+			sum += *it;
+		if (count == 0) {
+			printf("%-10s %10s %10s %10s %10zu\n", lure_name(lure), "-", "-", "-", gave_up);
+			continue;
+		}
+		printf("%-10s %10.1f %10.1f %10.1f %10zu\n", lure_name(lure), sum / count,
+			unlocked[count / 2], unlocked[std::min(count - 1, count * 9 / 10)], gave_up);
+	}
+
+	job_system.stop();
+	return EXIT_SUCCESS;
+}
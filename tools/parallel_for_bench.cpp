@@ -0,0 +1,80 @@
+// Microbenchmark of parallel_for over a component pool.
+// Moves a large number of synthetic bodies with every worker count from 0 up to one per
+// hardware thread and prints the time per pass and the speedup over a single thread.
+//
+// usage: parallel_for_bench [entity count] [passes]
+
+// stlib
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+// internal
+#include "tiny_ecs.hpp"
+#include "parallel_for.hpp"
+
+namespace
+{
+	struct Body {
+		float x, y;
+		float vx, vy;
+	};
+
+	const size_t CHUNK = 4096;
+
+	// a few dozen flops per body, roughly what the physics integration and boundary
+	// clamping cost per motion
+	void integrate(Body& body, float step_seconds)
+	{
+		float speed = std::sqrt(body.vx * body.vx + body.vy * body.vy);
+		float angle = std::atan2(body.vy, body.vx) + 0.01f;
+		body.vx = std::cos(angle) * speed;
+		body.vy = std::sin(angle) * speed;
+		body.x = std::fmin(std::fmax(body.x + body.vx * step_seconds, 0.f), 1984.f);
+		body.y = std::fmin(std::fmax(body.y + body.vy * step_seconds, 0.f), 1472.f);
+	}
+
+	double run_passes(ComponentContainer<Body>& bodies, int passes)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		for (int pass = 0; pass < passes; pass++) {
+			parallel_for(bodies, CHUNK, [](Body& body, Entity) {
+				integrate(body, 1.f / 120.f);
+			});
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<double, std::milli>(end - start).count() / passes;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	int entity_count = argc > 1 ? atoi(argv[1]) : 1000000;
+	int passes = argc > 2 ? atoi(argv[2]) : 20;
+
+	ComponentContainer<Body> bodies;
+	for (int i = 0; i < entity_count; i++) {
+		float f = (float)i;
+		bodies.emplace(Entity(), Body{ std::fmod(f * 7.f, 1984.f), std::fmod(f * 13.f, 1472.f), 50.f + std::fmod(f, 100.f), 30.f });
+	}
+
+	int hardware_threads = (int)std::thread::hardware_concurrency();
+	if (hardware_threads < 1)
+		hardware_threads = 1;
+	printf("%d entities, %d passes, %d hardware threads\n", entity_count, passes, hardware_threads);
+	printf("%8s %12s %8s\n", "threads", "ms / pass", "speedup");
+
+	double single_thread_ms = 0.0;
+	for (int workers = 0; workers < hardware_threads; workers++) {
+		job_system.start(workers);
+		run_passes(bodies, 1); // warm up the caches and wake the workers
+		double ms = run_passes(bodies, passes);
+		job_system.stop();
+		if (workers == 0)
+			single_thread_ms = ms;
+		printf("%8d %12.3f %7.2fx\n", workers + 1, ms, single_thread_ms / ms);
+	}
+	return EXIT_SUCCESS;
+}